@@ -0,0 +1,55 @@
+import numpy as np
+
+
+class PopulationHistory:
+    """
+    Memory-mapped reader for the population history written by minimacore's population_recorder.
+
+    The file holds a 64-byte header (magic, scalar size, version, genome size, objective count) followed by one block per
+    generation: generation and individual count (two uint64), then the genomes gene by gene and the objectives objective
+    by objective. Blocks are only indexed on opening; the arrays returned are views into the mapping.
+    """
+
+    MAGIC = b"MMCREC01"
+    HEADER_SIZE = 64
+    BLOCK_HEADER_SIZE = 16
+    SCALAR_TYPES = {4: np.float32, 8: np.float64, 16: np.longdouble}
+
+    def __init__(self, filename: str):
+        self.data = np.memmap(filename, dtype=np.uint8, mode='r')
+        if bytes(self.data[:8]) != self.MAGIC:
+            raise ValueError(f"{filename} is not a population history file")
+        scalar_size, self.version = np.frombuffer(self.data, dtype=np.uint32, count=2, offset=8)
+        self.genome_size, self.objective_count = (int(v) for v in
+                                                  np.frombuffer(self.data, dtype=np.uint64, count=2, offset=16))
+        self.dtype = np.dtype(self.SCALAR_TYPES[int(scalar_size)])
+        self.blocks = []
+        offset = self.HEADER_SIZE
+        while offset + self.BLOCK_HEADER_SIZE <= len(self.data):
+            generation, count = (int(v) for v in np.frombuffer(self.data, dtype=np.uint64, count=2, offset=offset))
+            block_size = count * (self.genome_size + self.objective_count) * self.dtype.itemsize
+            end = offset + self.BLOCK_HEADER_SIZE + block_size
+            if end > len(self.data):
+                # The last generation is still being written
+                break
+            self.blocks.append((generation, count, offset + self.BLOCK_HEADER_SIZE))
+            offset = end
+
+    def __len__(self):
+        return len(self.blocks)
+
+    def generation(self, index: int):
+        return self.blocks[index][0]
+
+    def genomes(self, index: int):
+        """Genomes of a recorded generation, as a (genome size, individuals) array."""
+        _, count, offset = self.blocks[index]
+        return np.frombuffer(self.data, dtype=self.dtype, count=self.genome_size * count,
+                             offset=offset).reshape(self.genome_size, count)
+
+    def fitness(self, index: int):
+        """Objectives of a recorded generation, as an (objective count, individuals) array."""
+        _, count, offset = self.blocks[index]
+        offset += self.genome_size * count * self.dtype.itemsize
+        return np.frombuffer(self.data, dtype=self.dtype, count=self.objective_count * count,
+                             offset=offset).reshape(self.objective_count, count)
@@ -3,6 +3,7 @@ import pandas as pd
 import matplotlib.pyplot as plt
 from matplotlib.animation import FuncAnimation
 from matplotlib import gridspec
+from population_history import PopulationHistory
 
 
 class Individual:
@@ -48,6 +49,16 @@ class Individual:
                 evolution.append(Individual.population_from_text(line))
         return evolution
 
+    @staticmethod
+    def evolution_from_history(filename):
+        history = PopulationHistory(filename)
+        evolution = []
+        for generation in range(len(history)):
+            genomes = history.genomes(generation)
+            fitness = history.fitness(generation)
+            evolution.append([Individual(genomes[:, [i]], float(fitness[0, i])) for i in range(genomes.shape[1])])
+        return evolution
+
 
 class EvolutionData:
 
@@ -193,7 +204,7 @@ if __name__ == "__main__":
     y = np.linspace(-5.12, 5.12, 500)
     x, y = np.meshgrid(x, y)
     z = np.genfromtxt("rastrigin.csv", delimiter=',')
-    evolution = EvolutionData(Individual.evolution_from_text('rastrigin_population_evolution.txt'))
+    evolution = EvolutionData(Individual.evolution_from_history('rastrigin_population_history.bin'))
     plot = ComparisonPlot(
         evolution, "rastrigin_statistics.csv", "Rastrigin Function", x, y, z, xlim=(-5.12, 5.12),
         ylim=(-5.12, 5.12),
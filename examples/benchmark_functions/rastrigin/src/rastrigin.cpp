@@ -3,6 +3,7 @@
 #include <selection_operators.h>
 #include <setup.h>
 #include <runner.h>
+#include <population_recorder.h>
 #include <iostream>
 #include <fstream>
 
@@ -14,8 +15,8 @@ inline T square(T value)
   return value * value;
 }
 
-template<floating_point_type T>
-inline T rastrigin(const Eigen::VectorX<T>& input)
+template<typename Derived, typename T = typename Derived::Scalar>
+inline T rastrigin(const Eigen::MatrixBase<Derived>& input)
 {
   T a = 10.;
   T result = a * input.size();
@@ -23,10 +24,10 @@ inline T rastrigin(const Eigen::VectorX<T>& input)
   return result;
 }
 
-template<floating_point_type F = double>
-class chromosome_generator_impl : public base_chromosome_generator<F> {
+template<floating_point_type F = double, int Dim_V = dynamic_dimension>
+class chromosome_generator_impl : public base_chromosome_generator<F, Dim_V> {
 public:
-  void generate_chromosome(const individual_ptr<F>& individual) const override
+  void generate_chromosome(const individual_ptr<F, Dim_V>& individual) const override
   {
     std::random_device device;
     std::mt19937_64 generator(device());
@@ -42,10 +43,10 @@ private:
   F upper_limit;
 };
 
-template<floating_point_type F>
-class rastrigin_evaluation_function : public base_evaluation<F> {
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class rastrigin_evaluation_function : public base_evaluation<F, Dim_V> {
 public:
-  size_t operator()(base_individual<F>& individual, size_t objective_index) const override
+  size_t operator()(base_individual<F, Dim_V>& individual, size_t objective_index) const override
   {
     individual.set_objective_fitness(objective_index, std::abs(rastrigin(individual.genome())));
     return ++objective_index;
@@ -73,29 +74,31 @@ int main(int argc, char** argv)
   ofs << output.format(fmt);
   ofs.close();
 
+  // The problem is two-dimensional, so genomes are stored inline as fixed-size vectors
+  constexpr int dimension = 2;
   Eigen::Vector2d initial_genome(-5.12, -5.12); // Initializes genome at the edge of the boundaries
-  auto genome_gen = std::make_unique<genome_generator<double>>(initial_genome);
-  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<double>>(-5.12, 5.12));
-  setup<double> s;
+  auto genome_gen = std::make_unique<genome_generator<double, dimension>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<double, dimension>>(-5.12, 5.12));
+  setup<double, dimension> s;
   s.set_population_size(100)
           .set_generations(50)
-          .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<double>>(50))
-          .set_selection_for_reproduction(std::make_unique<tournament_selection_for_reproduction<double>>(5, 10))
-          .set_crossover(std::make_unique<uniform_voluminal_crossover<double>>(2))
-          .set_mutation(std::make_unique<gaussian_mutation<double>>(0.05, .5))
+          .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<double, dimension>>(50))
+          .set_selection_for_reproduction(
+                  std::make_unique<tournament_selection_for_reproduction<double, dimension>>(5, 10))
+          .set_crossover(std::make_unique<uniform_voluminal_crossover<double, dimension>>(2))
+          .set_mutation(std::make_unique<gaussian_mutation<double, dimension>>(0.05, .5))
           .set_genome_generator(std::move(genome_gen))
-          .add_evaluation(std::make_unique<rastrigin_evaluation_function<double>>());
-  runner<double> r(std::move(s));
-  std::ofstream individuals_ofs("rastrigin_population_evolution.txt");
-  auto save_individuals = [&r, &individuals_ofs]() {
-    Eigen::IOFormat fmt(6, 0, ",");
-    for (auto& individual : r.get_population())
-      individuals_ofs << individual->genome().transpose().format(fmt) << "," << individual->objective_fitness(0) << ";";
-    individuals_ofs << '\n';
-  };
-  r.get_setup().add_callback(save_individuals);
+          .add_evaluation(std::make_unique<rastrigin_evaluation_function<double, dimension>>());
+  runner<double, dimension> r(std::move(s));
+  // Every generation is recorded off the generation loop, from snapshots handed to an asynchronous callback
+  population_recorder<double, dimension> recorder("rastrigin_population_history.bin", dimension, 1);
+  r.get_setup()
+          .set_async_callback_queue(4, overflow_policy::BLOCK)
+          .add_async_callback([&recorder](const population_snapshot<double, dimension>& snapshot) {
+            recorder.record(snapshot.population, snapshot.generation);
+          });
   r.add_log_stream(std::cout);
-  if (r.run() == runner<double>::exit_flag::SUCCESS) {
+  if (r.run() == runner<double, dimension>::exit_flag::SUCCESS) {
     r.export_statistics("rastrigin_statistics.csv", ',');
     return 0;
   }
@@ -0,0 +1,224 @@
+
+#ifndef MINIMACORE_ASYNC_CALLBACKS_H
+#define MINIMACORE_ASYNC_CALLBACKS_H
+
+#include "base_individual.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief What publishing a snapshot does when the queue of pending snapshots is full.
+   */
+  enum class overflow_policy : std::uint8_t {
+    DROP_OLDEST = 0, // the oldest pending snapshot is discarded, observers always see the latest generation
+    DROP_NEWEST,     // the new snapshot is discarded
+    BLOCK,           // the generation loop waits for a free slot (backpressure), no snapshot is lost
+  };
+
+  /**
+   * @brief Immutable view of a generation. It shares the individuals of the population instead of copying them: while a
+   * snapshot references an individual, the runner's pool cannot recycle it, so the snapshot never sees it change.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> struct population_snapshot {
+    size_t generation{0};
+    population_t<Fp_T, Dim_V> population;
+    individual_ptr<Fp_T, Dim_V> best;
+  };
+
+  /**
+   * @brief Runs observers of the generations on a background thread. The generation loop publishes a snapshot into a
+   * bounded queue and carries on; the worker hands each snapshot to every callback in registration order.
+   *
+   * Snapshot buffers are recycled: with a queue of `capacity` snapshots at most `capacity + 1` exist (one being read by
+   * the worker), which is double buffering for a capacity of 1. The worker starts with the first published snapshot.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class async_callbacks {
+  public:
+    using snapshot_t = population_snapshot<Fp_T, Dim_V>;
+    using callback_t = std::function<void(const snapshot_t &)>;
+
+    /**
+     * @brief Registers a callback, must be called before the first snapshot is published.
+     */
+    void add(callback_t &&callback) {
+      _callbacks.emplace_back(std::move(callback));
+    }
+
+    [[nodiscard]] bool empty() const {
+      return _callbacks.empty();
+    }
+
+    /**
+     * @brief Sets the queue capacity and overflow policy, must be called before the first snapshot is published.
+     */
+    void configure(size_t capacity, overflow_policy policy) {
+      _capacity = std::max<size_t>(capacity, 1);
+      _policy = policy;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+      return _capacity;
+    }
+
+    [[nodiscard]] overflow_policy policy() const {
+      return _policy;
+    }
+
+    /**
+     * @brief Number of snapshots waiting for the worker.
+     */
+    [[nodiscard]] size_t pending() const {
+      std::lock_guard lock(_mutex);
+      return _queue.size();
+    }
+
+    /**
+     * @brief Number of snapshots discarded by the overflow policy.
+     */
+    [[nodiscard]] size_t dropped() const {
+      std::lock_guard lock(_mutex);
+      return _dropped;
+    }
+
+    /**
+     * @brief Number of snapshots handed to the callbacks.
+     */
+    [[nodiscard]] size_t delivered() const {
+      std::lock_guard lock(_mutex);
+      return _delivered;
+    }
+
+    /**
+     * @brief Queues a snapshot of the generation. Only waits when the queue is full and the policy is BLOCK.
+     */
+    void publish(size_t generation, const population_t<Fp_T, Dim_V> &population,
+                 const individual_ptr<Fp_T, Dim_V> &best) {
+      if (empty()) {
+        return;
+      }
+      std::unique_lock lock(_mutex);
+      if (!_worker.joinable()) {
+        _worker = std::thread([this]() { work(); });
+      }
+      if (_queue.size() >= _capacity) {
+        switch (_policy) {
+        case overflow_policy::DROP_OLDEST:
+          recycle(std::move(_queue.front()));
+          _queue.pop_front();
+          _dropped++;
+          break;
+        case overflow_policy::DROP_NEWEST:
+          _dropped++;
+          return;
+        case overflow_policy::BLOCK:
+          _space.wait(lock, [this]() { return _queue.size() < _capacity; });
+          break;
+        }
+      }
+      snapshot_t snapshot = take_buffer();
+      snapshot.generation = generation;
+      snapshot.population.assign(population.begin(), population.end());
+      snapshot.best = best;
+      _queue.push_back(std::move(snapshot));
+      lock.unlock();
+      _work.notify_one();
+    }
+
+    /**
+     * @brief Blocks until every queued snapshot has been delivered.
+     */
+    void drain() {
+      std::unique_lock lock(_mutex);
+      _idle.wait(lock, [this]() { return _queue.empty() && !_busy; });
+    }
+
+    /**
+     * @param capacity Maximum number of snapshots waiting for the worker
+     * @param policy Behaviour when publishing into a full queue
+     */
+    explicit async_callbacks(size_t capacity = 1, overflow_policy policy = overflow_policy::DROP_OLDEST)
+        : _capacity(std::max<size_t>(capacity, 1)), _policy(policy) {}
+
+    async_callbacks(const async_callbacks &) = delete;
+    async_callbacks(async_callbacks &&) = delete;
+    async_callbacks &operator=(const async_callbacks &) = delete;
+    async_callbacks &operator=(async_callbacks &&) = delete;
+
+    ~async_callbacks() {
+      {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+      }
+      _work.notify_one();
+      if (_worker.joinable()) {
+        _worker.join();
+      }
+    }
+
+  private:
+    snapshot_t take_buffer() {
+      if (_buffers.empty()) {
+        return {};
+      }
+      snapshot_t buffer = std::move(_buffers.back());
+      _buffers.pop_back();
+      return buffer;
+    }
+
+    void recycle(snapshot_t &&snapshot) {
+      // Dropping the references lets the pool recycle the individuals, the vector keeps its capacity
+      snapshot.population.clear();
+      snapshot.best.reset();
+      _buffers.emplace_back(std::move(snapshot));
+    }
+
+    void work() {
+      std::unique_lock lock(_mutex);
+      while (true) {
+        _work.wait(lock, [this]() { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+          return;
+        }
+        snapshot_t snapshot = std::move(_queue.front());
+        _queue.pop_front();
+        _busy = true;
+        lock.unlock();
+        _space.notify_one();
+        for (auto &callback : _callbacks) {
+          callback(snapshot);
+        }
+        lock.lock();
+        _busy = false;
+        _delivered++;
+        recycle(std::move(snapshot));
+        if (_queue.empty()) {
+          _idle.notify_all();
+        }
+      }
+    }
+
+    size_t _capacity;
+    overflow_policy _policy;
+    vector<callback_t> _callbacks;
+    mutable std::mutex _mutex;
+    std::condition_variable _work;
+    std::condition_variable _space;
+    std::condition_variable _idle;
+    std::deque<snapshot_t> _queue;
+    vector<snapshot_t> _buffers;
+    size_t _dropped{0};
+    size_t _delivered{0};
+    bool _busy{false};
+    bool _stop{false};
+    std::thread _worker;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_ASYNC_CALLBACKS_H
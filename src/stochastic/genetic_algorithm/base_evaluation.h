@@ -4,21 +4,68 @@
 
 #include "base_individual.h"
 
+#include <cancellation_token.h>
+#include <limits>
+#include <parallel_reduce.h>
+
 namespace minimacore::genetic_algorithm {
 
-template<floating_point_type F>
+template<floating_point_type F, int Dim_V = dynamic_dimension>
 class base_evaluation {
 public:
   /**
-   * @brief Evaluates the individual and writes the objective functions to the object.
+   * @brief Evaluates the individual and writes the objective functions to the object. Data-heavy evaluations can split
+   * their loop with minimacore::parallel_reduce, which the runner lets use the idle workers when the population is too
+   * small to occupy them. Multi-fidelity evaluations evaluate at the level given by individual.fidelity().
    * @param individual
    * @param objective_index
    * @return The index of the next objective to be filled by the next evaluation
    */
-  [[nodiscard]] virtual size_t operator()(base_individual<F>& individual, size_t objective_index) const = 0;
+  [[nodiscard]] virtual size_t operator()(base_individual<F, Dim_V>& individual, size_t objective_index) const = 0;
+  
+  /**
+   * @brief Cancellable evaluation, called by the runner. Long evaluations should override it and poll the token, which
+   * is cancelled when the evaluation exceeds its time limit or the run its budget; the result of a cancelled evaluation
+   * is discarded. Defaults to the uncancellable evaluation.
+   */
+  [[nodiscard]] virtual size_t operator()(base_individual<F, Dim_V>& individual, size_t objective_index,
+                                          const cancellation_token& /* token */) const
+  {
+    return (*this)(individual, objective_index);
+  }
   
   [[nodiscard]] virtual size_t objective_count() const = 0;
   
+  /**
+   * @brief Called by the runner before the evaluations of each generation start. Evaluations whose fidelity changes
+   * along the run (e.g. dataset_evaluation) adapt it here.
+   * @return Whether the fitness given by earlier generations is no longer comparable with the next evaluations, in
+   * which case the runner evaluates the population again before selecting
+   */
+  virtual bool begin_generation(size_t /* generation */, size_t /* generations */)
+  {
+    return false;
+  }
+  
+  /**
+   * @brief Lower bound of the sum of the objectives written by this evaluation, for any individual. With evaluation
+   * pruning the evaluations left are skipped once the partial fitness plus their bounds exceeds the survival threshold.
+   * Unbounded by default, which disables pruning before this evaluation.
+   */
+  [[nodiscard]] virtual F lower_bound() const
+  {
+    return -std::numeric_limits<F>::infinity();
+  }
+  
+  /**
+   * @brief Cost of the evaluation relative to the others of the setup, which runs the cheapest first so that pruning
+   * skips the expensive ones. Objectives keep the order in which the evaluations were added.
+   */
+  [[nodiscard]] virtual double relative_cost() const
+  {
+    return 1.;
+  }
+  
   virtual ~base_evaluation() = default;
 };
 
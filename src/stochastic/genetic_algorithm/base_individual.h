@@ -3,8 +3,12 @@
 #define MINIMACORE_BASE_INDIVIDUAL_H
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <minimacore_concepts.h>
+#include <mutex>
 #include <random>
 #include <vector>
 
@@ -14,9 +18,85 @@ namespace minimacore::genetic_algorithm {
   using std::unique_ptr;
   using std::vector;
 
-  template <floating_point_type Fp_T> using genome_t = Eigen::VectorX<Fp_T>;
+  /**
+   * @brief Genome length used when the dimension is only known at runtime (heap-allocated genomes).
+   */
+  inline constexpr int dynamic_dimension = Eigen::Dynamic;
 
-  template <floating_point_type Fp_T> class base_individual {
+  /**
+   * @brief Genome storage. With a compile-time dimension the genome lives inline in a fixed-size (and, for suitable
+   * sizes, SIMD-aligned) Eigen vector, otherwise it is a heap-allocated dynamic vector.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> using genome_t = Eigen::Matrix<Fp_T, Dim_V, 1>;
+
+  /**
+   * @brief Block of genomes stored column by column, used by the batch variation kernels.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using genome_batch_t = Eigen::Matrix<Fp_T, Dim_V, Eigen::Dynamic>;
+
+  /**
+   * @brief Sparse genome edit: the genes at `indices` take the matching `values`, every other gene is left unchanged.
+   * Values are absolute, so applying a delta twice, or applying a later delta over it, is well defined.
+   */
+  template <floating_point_type Fp_T> struct genome_delta {
+    vector<Eigen::Index> indices;
+    vector<Fp_T> values;
+
+    void clear() {
+      indices.clear();
+      values.clear();
+    }
+
+    [[nodiscard]] size_t size() const {
+      return indices.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+      return indices.empty();
+    }
+
+    template <int Dim_V> void apply_to(genome_t<Fp_T, Dim_V> &genome) const {
+      for (size_t i = 0; i < indices.size(); i++) {
+        genome(indices[i]) = values[i];
+      }
+    }
+
+    /**
+     * @brief Replaces this delta by `base` followed by `edit`. Both must have strictly increasing indices, as does the
+     * result; on a shared index the value of `edit` wins.
+     */
+    void merge(const genome_delta &base, const genome_delta &edit) {
+      clear();
+      size_t i = 0;
+      size_t j = 0;
+      while (i < base.size() || j < edit.size()) {
+        if (j == edit.size() || (i < base.size() && base.indices[i] < edit.indices[j])) {
+          indices.push_back(base.indices[i]);
+          values.push_back(base.values[i++]);
+        } else {
+          i += i < base.size() && base.indices[i] == edit.indices[j];
+          indices.push_back(edit.indices[j]);
+          values.push_back(edit.values[j++]);
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief A copy-on-write offspring is made dense as soon as its delta covers more than 1/ratio of the genome, beyond
+   * which the delta costs more than the copy it avoids.
+   */
+  inline constexpr Eigen::Index delta_compaction_ratio = 8;
+
+  /**
+   * @brief Individual of the population. Its genome is either dense, or copy-on-write: a reference to a dense root
+   * ancestor plus a sparse delta (see derive). A copy-on-write genome is materialized the first time a dense view is
+   * requested; reading single genes through gene() never materializes it.
+   *
+   * The const accessors may be used concurrently. The non-const accessors and derive/reset require exclusive access.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class base_individual {
 
   public:
     Fp_T overall_fitness() const {
@@ -45,34 +125,234 @@ namespace minimacore::genetic_algorithm {
       return _fitness_values(index);
     }
 
-    const genome_t<Fp_T> &genome() const {
+    const genome_t<Fp_T, Dim_V> &genome() const {
+      if (_lazy.load(std::memory_order_acquire)) {
+        materialize();
+      }
       return _genome;
     }
 
-    genome_t<Fp_T> &genome() {
+    genome_t<Fp_T, Dim_V> &genome() {
+      if (_lazy.load(std::memory_order_acquire)) {
+        materialize();
+      }
+      _root.reset();
+      _delta.clear();
       return _genome;
     }
 
+    /**
+     * @brief Reads a single gene without materializing a copy-on-write genome.
+     */
+    Fp_T gene(Eigen::Index index) const {
+      if (_lazy.load(std::memory_order_acquire)) {
+        const auto it = std::ranges::lower_bound(_delta.indices, index);
+        if (it != _delta.indices.end() && *it == index) {
+          return _delta.values[size_t(it - _delta.indices.begin())];
+        }
+        return _root->genome()(index);
+      }
+      return _genome(index);
+    }
+
+    [[nodiscard]] Eigen::Index genome_size() const {
+      return _lazy.load(std::memory_order_acquire) ? _root->genome_size() : _genome.size();
+    }
+
+    /**
+     * @brief True while the genome is only held as a root and a delta.
+     */
+    [[nodiscard]] bool is_lazy() const {
+      return _lazy.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Dense ancestor of a copy-on-write genome, null once the genome is dense. Evaluations able to work on
+     * deltas can read root()->genome() and delta() instead of the dense genome.
+     */
+    const shared_ptr<const base_individual> &root() const {
+      return _root;
+    }
+
+    const genome_delta<Fp_T> &delta() const {
+      return _delta;
+    }
+
+    /**
+     * @brief Turns this individual into a copy-on-write offspring of `parent` whose genes differ by `delta` (strictly
+     * increasing indices). A lazy parent is skipped: the offspring refers to the parent's root with both deltas merged,
+     * so chains never grow past one level. The offspring is made dense right away if the merged delta is too large.
+     */
+    void derive(const shared_ptr<const base_individual> &parent, const genome_delta<Fp_T> &delta) {
+      {
+        std::lock_guard lock(parent->_mutex);
+        if (parent->_lazy.load(std::memory_order_acquire)) {
+          _root = parent->_root;
+          _delta.merge(parent->_delta, delta);
+        } else {
+          _root = parent;
+          _delta = delta;
+        }
+      }
+      _lazy.store(true, std::memory_order_release);
+      if (Eigen::Index(_delta.size()) * delta_compaction_ratio > _root->genome_size()) {
+        genome();
+      }
+    }
+
     [[nodiscard]] bool is_valid() const {
       return _fitness_values.allFinite();
     }
 
-    explicit base_individual(genome_t<Fp_T> genome, long objective_count)
-        : _genome(genome), _fitness_values(objective_count) {
+    /**
+     * @brief True if evaluation pruning skipped objectives of the individual, which then hold their lower bounds: its
+     * fitness underestimates the true one, and is known to be worse than every survivor of its generation.
+     */
+    [[nodiscard]] bool is_rejected() const {
+      return _rejected;
+    }
+
+    void set_rejected(bool rejected) {
+      _rejected = rejected;
+    }
+
+    /**
+     * @brief Fidelity level the individual is evaluated at, 0 being the lowest, see
+     * setup_base::set_successive_halving. Once evaluated, the level its fitness comes from.
+     */
+    [[nodiscard]] size_t fidelity() const {
+      return _fidelity;
+    }
+
+    void set_fidelity(size_t fidelity) {
+      _fidelity = fidelity;
+    }
+
+    /**
+     * @brief Number of evaluations averaged into the objectives, more than one for noisy evaluations raced by the
+     * runner (see setup_base::set_racing).
+     */
+    [[nodiscard]] size_t samples() const {
+      return _samples;
+    }
+
+    /**
+     * @brief Sample variance of the overall fitness over the evaluations averaged, NaN with a single sample.
+     */
+    [[nodiscard]] Fp_T fitness_variance() const {
+      return _samples > 1 ? _fitness_m2 / Fp_T(_samples - 1) : std::numeric_limits<Fp_T>::quiet_NaN();
+    }
+
+    /**
+     * @brief Folds the objectives of another evaluation into the running mean held by the objectives.
+     */
+    void add_sample(const Eigen::Ref<const Eigen::VectorX<Fp_T>> &objectives) {
+      const Fp_T previous_mean = overall_fitness();
+      _samples++;
+      _fitness_values += (objectives - _fitness_values) / Fp_T(_samples);
+      _fitness_m2 += (objectives.sum() - previous_mean) * (objectives.sum() - overall_fitness());
+    }
+
+    /**
+     * @brief Makes the objectives a single sample, once an evaluation overwrote them.
+     */
+    void reset_samples() {
+      _samples = 1;
+      _fitness_m2 = 0;
+    }
+
+    /**
+     * @brief Prepares a recycled individual for reuse. Buffers are only reallocated when their sizes change.
+     */
+    void reset(Eigen::Index genome_size, long objective_count) {
+      _root.reset();
+      _delta.clear();
+      _lazy.store(false, std::memory_order_release);
+      _genome.resize(genome_size);
+      _fitness_values.resize(objective_count);
+      _fitness_values.setConstant(NAN);
+      _rejected = false;
+      _fidelity = 0;
+      reset_samples();
+    }
+
+    explicit base_individual(genome_t<Fp_T, Dim_V> genome, long objective_count)
+        : _genome(std::move(genome)), _fitness_values(objective_count) {
       _fitness_values.setConstant(NAN);
     }
 
+    base_individual(const base_individual &other)
+        : _genome(other.genome()), _fitness_values(other._fitness_values), _rejected(other._rejected),
+          _fidelity(other._fidelity), _samples(other._samples), _fitness_m2(other._fitness_m2) {}
+
+    base_individual(base_individual &&other) noexcept
+        : _genome(std::move(other._genome)), _fitness_values(std::move(other._fitness_values)),
+          _root(std::move(other._root)), _delta(std::move(other._delta)), _lazy(other._lazy.load()),
+          _rejected(other._rejected), _fidelity(other._fidelity), _samples(other._samples),
+          _fitness_m2(other._fitness_m2) {}
+
+    base_individual &operator=(const base_individual &other) {
+      if (this != &other) {
+        _genome = other.genome();
+        _fitness_values = other._fitness_values;
+        _rejected = other._rejected;
+        _fidelity = other._fidelity;
+        _samples = other._samples;
+        _fitness_m2 = other._fitness_m2;
+        _root.reset();
+        _delta.clear();
+        _lazy.store(false, std::memory_order_release);
+      }
+      return *this;
+    }
+
+    base_individual &operator=(base_individual &&other) noexcept {
+      _genome = std::move(other._genome);
+      _fitness_values = std::move(other._fitness_values);
+      _root = std::move(other._root);
+      _delta = std::move(other._delta);
+      _lazy.store(other._lazy.load());
+      _rejected = other._rejected;
+      _fidelity = other._fidelity;
+      _samples = other._samples;
+      _fitness_m2 = other._fitness_m2;
+      return *this;
+    }
+
+    ~base_individual() = default;
+
   private:
-    genome_t<Fp_T> _genome;
+    void materialize() const {
+      std::lock_guard lock(_mutex);
+      if (!_lazy.load(std::memory_order_relaxed)) {
+        return;
+      }
+      _genome = _root->genome();
+      _delta.apply_to(_genome);
+      _lazy.store(false, std::memory_order_release);
+    }
+
+    mutable genome_t<Fp_T, Dim_V> _genome;
     Eigen::VectorX<Fp_T> _fitness_values;
+    shared_ptr<const base_individual> _root;
+    genome_delta<Fp_T> _delta;
+    mutable std::atomic<bool> _lazy{false};
+    mutable std::mutex _mutex;
+    bool _rejected{false};
+    size_t _fidelity{0};
+    size_t _samples{1};
+    Fp_T _fitness_m2{0};
   };
 
-  template <floating_point_type Fp_T> using individual_ptr = shared_ptr<base_individual<Fp_T>>;
-  template <floating_point_type Fp_T> using population_t = vector<individual_ptr<Fp_T>>;
-  template <floating_point_type Fp_T> using reproduction_selection_t = vector<individual_ptr<Fp_T>>;
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using individual_ptr = shared_ptr<base_individual<Fp_T, Dim_V>>;
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using population_t = vector<individual_ptr<Fp_T, Dim_V>>;
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using reproduction_selection_t = vector<individual_ptr<Fp_T, Dim_V>>;
 
-  template <floating_point_type Fp_T>
-  static const individual_ptr<Fp_T> &random_pick(const population_t<Fp_T> &selection_set) {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  static const individual_ptr<Fp_T, Dim_V> &random_pick(const population_t<Fp_T, Dim_V> &selection_set) {
     std::random_device device{};
     std::mt19937_64 generator{static_cast<std::mt19937_64::result_type>(device())};
     std::uniform_int_distribution<size_t> distribution{0, selection_set.size() - 1};
@@ -6,44 +6,44 @@
 
 namespace minimacore::genetic_algorithm {
 
-template<floating_point_type F>
+template<floating_point_type F, int Dim_V = dynamic_dimension>
 class base_chromosome_generator {
 public:
-  virtual void generate_chromosome(const individual_ptr<F>& individual) const = 0;
+  virtual void generate_chromosome(const individual_ptr<F, Dim_V>& individual) const = 0;
   
   virtual ~base_chromosome_generator() = default;
 };
 
-template<floating_point_type F>
-using chromosome_generator_ptr = unique_ptr<base_chromosome_generator<F>>;
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+using chromosome_generator_ptr = unique_ptr<base_chromosome_generator<F, Dim_V>>;
 
-template<floating_point_type F>
+template<floating_point_type F, int Dim_V = dynamic_dimension>
 class genome_generator {
 public:
-  const individual_ptr<F>& operator()(const individual_ptr<F>& individual) const
+  const individual_ptr<F, Dim_V>& operator()(const individual_ptr<F, Dim_V>& individual) const
   {
     for (auto& generator : _chromosome_generators)
       generator->generate_chromosome(individual);
     return individual;
   }
   
-  void append_chromosome_generator(chromosome_generator_ptr<F> chromosome_generator)
+  void append_chromosome_generator(chromosome_generator_ptr<F, Dim_V> chromosome_generator)
   {
     _chromosome_generators.push_back(std::move(chromosome_generator));
   }
   
-  const Eigen::VectorX<F>& initial_genome() const
+  const genome_t<F, Dim_V>& initial_genome() const
   {
     return _initial_genome;
   }
   
-  explicit genome_generator(const Eigen::VectorX<F>& initial_genome)
+  explicit genome_generator(const genome_t<F, Dim_V>& initial_genome)
       : _initial_genome(initial_genome)
   {}
 
 private:
-  Eigen::VectorX<F> _initial_genome;
-  vector<chromosome_generator_ptr<F>> _chromosome_generators;
+  genome_t<F, Dim_V> _initial_genome;
+  vector<chromosome_generator_ptr<F, Dim_V>> _chromosome_generators;
 };
 
 }
@@ -0,0 +1,141 @@
+
+#ifndef MINIMACORE_DATASET_EVALUATION_H
+#define MINIMACORE_DATASET_EVALUATION_H
+
+#include "base_evaluation.h"
+#include "mapped_dataset.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Single-objective evaluation fitting a model to a mapped_dataset, shared zero-copy by every evaluating
+   * thread. The fitness is the mean loss over the scored rows, computed with parallel_reduce so that small populations
+   * spread the rows of one individual over the idle workers.
+   *
+   * With mini-batches enabled, the individuals of a generation are scored on one random window of consecutive rows (the
+   * same for the whole generation), and the last generations on the full dataset. Whenever the window moves, including
+   * at the switch to the full dataset, the runner scores the survivors again, so they compete with the offspring on the
+   * same rows.
+   * Whenever a mini-batch score reaches the best full-dataset score seen so far, the individual is rescored on the full
+   * dataset, so candidate elites always carry an exact fitness. Rows should be shuffled when stored, so that windows are
+   * representative samples.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class dataset_evaluation : public base_evaluation<Fp_T, Dim_V> {
+  public:
+    using rows_t = typename mapped_dataset<Fp_T>::block_t;
+
+    size_t operator()(base_individual<Fp_T, Dim_V> &individual, size_t objective_index) const override {
+      const size_t rows = _dataset->rows();
+      const size_t first = _batch_first.load(std::memory_order_relaxed);
+      const size_t count = std::min(_batch_count.load(std::memory_order_relaxed), rows - std::min(first, rows));
+      Fp_T fitness = mean_loss(individual, first, count);
+      if (count < rows && double(fitness) <= _best_full_loss.load(std::memory_order_relaxed)) {
+        fitness = mean_loss(individual, 0, rows);
+        _promotions.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (count == rows || double(fitness) <= _best_full_loss.load(std::memory_order_relaxed)) {
+        update_best_full_loss(fitness);
+      }
+      individual.set_objective_fitness(objective_index, fitness);
+      return ++objective_index;
+    }
+
+    [[nodiscard]] size_t objective_count() const override {
+      return 1;
+    }
+
+    /**
+     * @brief Draws the mini-batch of the generation, or selects the full dataset once the mini-batch phase is over.
+     * @return Whether the scored rows changed
+     */
+    bool begin_generation(size_t generation, size_t generations) override {
+      const size_t rows = _dataset->rows();
+      size_t first = 0;
+      size_t count = rows;
+      if (_batch_rows > 0 && _batch_rows < rows && double(generation) < _mini_batch_fraction * double(generations)) {
+        std::uniform_int_distribution<size_t> distribution(0, rows - _batch_rows);
+        first = distribution(_generator);
+        count = _batch_rows;
+        _dataset->prefetch(first, _batch_rows);
+      }
+      const size_t previous_first = _batch_first.exchange(first, std::memory_order_relaxed);
+      const size_t previous_count = _batch_count.exchange(count, std::memory_order_relaxed);
+      return first != previous_first || count != previous_count;
+    }
+
+    /**
+     * @brief Scores the individuals on windows of `batch_rows` rows during the first `fraction` of the generations.
+     */
+    dataset_evaluation &set_mini_batches(size_t batch_rows, double fraction = .8) {
+      _batch_rows = batch_rows;
+      _mini_batch_fraction = std::clamp(fraction, 0., 1.);
+      return *this;
+    }
+
+    [[nodiscard]] const mapped_dataset<Fp_T> &dataset() const {
+      return *_dataset;
+    }
+
+    /**
+     * @brief Number of mini-batch scores promoted to a full-dataset evaluation.
+     */
+    [[nodiscard]] size_t promotions() const {
+      return _promotions.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @param dataset Dataset shared with other evaluations or runs
+     * @param grain Fewest rows a worker scores when the rows of one individual are split
+     */
+    explicit dataset_evaluation(std::shared_ptr<const mapped_dataset<Fp_T>> dataset, size_t grain = 4096)
+        : _dataset(std::move(dataset)), _grain(grain), _batch_count(_dataset->rows()) {}
+
+  protected:
+    /**
+     * @brief Summed loss of the individual over a block of consecutive rows (count x columns).
+     */
+    [[nodiscard]] virtual Fp_T loss(const base_individual<Fp_T, Dim_V> &individual, const rows_t &rows) const = 0;
+
+  private:
+    Fp_T mean_loss(const base_individual<Fp_T, Dim_V> &individual, size_t first, size_t count) const {
+      if (count == 0) {
+        return std::numeric_limits<Fp_T>::quiet_NaN();
+      }
+      const Fp_T total = parallel_reduce(
+          count, Fp_T(0),
+          [this, &individual, first](size_t begin, size_t end) {
+            return loss(individual, _dataset->block(first + begin, end - begin));
+          },
+          std::plus<>{}, _grain);
+      return total / Fp_T(count);
+    }
+
+    void update_best_full_loss(Fp_T fitness) const {
+      const double loss = double(fitness);
+      double best = _best_full_loss.load(std::memory_order_relaxed);
+      while (loss < best && !_best_full_loss.compare_exchange_weak(best, loss, std::memory_order_relaxed)) {
+      }
+    }
+
+    std::shared_ptr<const mapped_dataset<Fp_T>> _dataset;
+    size_t _grain;
+    size_t _batch_rows{0};
+    double _mini_batch_fraction{.8};
+    std::mt19937_64 _generator{std::random_device{}()};
+    std::atomic_size_t _batch_first{0};
+    std::atomic_size_t _batch_count;
+    // Kept in double precision, atomics of long double are not lock-free
+    mutable std::atomic<double> _best_full_loss{std::numeric_limits<double>::infinity()};
+    mutable std::atomic_size_t _promotions{0};
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_DATASET_EVALUATION_H
@@ -4,18 +4,44 @@
 
 #include "base_individual.h"
 #include <minimacore_concepts.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <limits>
 
 namespace minimacore::genetic_algorithm {
 
 using std::string;
 
+/**
+ * @brief Overall fitness of every individual, gathered once per generation so that statistics do not depend on the
+ * genome representation.
+ */
+template<floating_point_type F>
+using fitness_view_t = Eigen::Ref<const Eigen::VectorX<F>>;
+
+template<floating_point_type F, int Dim_V>
+void overall_fitness(const population_t<F, Dim_V>& population, Eigen::VectorX<F>& fitness)
+{
+  fitness.resize(Eigen::Index(population.size()));
+  for (size_t i = 0; i < population.size(); i++) fitness(Eigen::Index(i)) = population[i]->overall_fitness();
+}
+
 template<floating_point_type F>
 class statistic_request_base {
 public:
   [[nodiscard]] virtual const char* name() const = 0;
 
-  [[nodiscard]] virtual F operator()(const population_t<F>& population) const = 0;
+  [[nodiscard]] virtual F compute(const fitness_view_t<F>& fitness) const = 0;
+
+  template<int Dim_V>
+  [[nodiscard]] F operator()(const population_t<F, Dim_V>& population) const
+  {
+    Eigen::VectorX<F> fitness;
+    overall_fitness(population, fitness);
+    return compute(fitness);
+  }
 
   virtual ~statistic_request_base() = default;
 };
@@ -28,13 +54,9 @@ public:
     return "best_fitness";
   }
 
-  [[nodiscard]] F operator()(const population_t<F>& population) const override
+  [[nodiscard]] F compute(const fitness_view_t<F>& fitness) const override
   {
-    auto element = std::ranges::min(
-            population,
-            [](auto& a, auto& b) { return a->overall_fitness() < b->overall_fitness(); }
-    );
-    return element->overall_fitness();
+    return fitness.minCoeff();
   };
 };
 
@@ -46,13 +68,9 @@ public:
     return "average_fitness";
   }
 
-  [[nodiscard]] F operator()(const population_t<F>& population) const override
+  [[nodiscard]] F compute(const fitness_view_t<F>& fitness) const override
   {
-    return std::accumulate(
-            population.begin(), population.end(), 0.,
-            [](F current, auto& individual) { return current + individual->overall_fitness(); }
-    ) /
-            (F) population.size();
+    return fitness.mean();
   };
 };
 
@@ -64,9 +82,9 @@ public:
     return "selection_pressure";
   }
 
-  [[nodiscard]] F operator()(const population_t<F>& population) const override
+  [[nodiscard]] F compute(const fitness_view_t<F>& fitness) const override
   {
-    return best_fitness_request<F>{}(population) / average_fitness_request<F>{}(population);
+    return best_fitness_request<F>{}.compute(fitness) / average_fitness_request<F>{}.compute(fitness);
   };
 };
 
@@ -110,11 +128,18 @@ public:
     return _generation;
   }
 
-  void register_statistic(const population_t<F>& population)
+  template<int Dim_V>
+  void register_statistic(const population_t<F, Dim_V>& population)
+  {
+    overall_fitness(population, _fitness);
+    register_statistic(_fitness);
+  }
+
+  void register_statistic(const fitness_view_t<F>& fitness)
   {
     for (size_t i = 0; i < _requests.size(); i++)
       if (auto req = _requests_factory->make(_requests[i]))
-        _statistics(_generation, i) = (*req)(population);
+        _statistics(_generation, i) = req->compute(fitness);
     ++_generation;
   }
 
@@ -133,6 +158,73 @@ public:
     return _generation >= _statistics.rows() ? _generation : ++_generation;
   }
 
+  /**
+   * @brief Records a named value (e.g. a hardware counter) for the last registered generation. Metrics are exported as
+   * extra columns after the statistics, empty for the generations they were not recorded for.
+   */
+  void record_metric(const string& name, double value)
+  {
+    if (_generation == 0) {
+      return;
+    }
+    auto it = std::ranges::find(_metric_names, name);
+    if (it == _metric_names.end()) {
+      _metric_names.push_back(name);
+      _metrics.emplace_back();
+      it = _metric_names.end() - 1;
+    }
+    auto& values = _metrics[size_t(it - _metric_names.begin())];
+    values.resize(std::max(values.size(), _generation), std::numeric_limits<double>::quiet_NaN());
+    values[_generation - 1] = value;
+  }
+
+  [[nodiscard]] const vector<string>& metric_names() const
+  {
+    return _metric_names;
+  }
+
+  /**
+   * @brief Value of a metric for a generation, NaN if it was not recorded.
+   */
+  [[nodiscard]] double metric(const string& name, size_t generation) const
+  {
+    const auto it = std::ranges::find(_metric_names, name);
+    if (it == _metric_names.end()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    const auto& values = _metrics[size_t(it - _metric_names.begin())];
+    return generation < values.size() ? values[generation] : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  /**
+   * @brief Names of the exported columns: the requested statistics, then the metrics.
+   */
+  [[nodiscard]] vector<string> column_names() const
+  {
+    vector<string> names;
+    for (auto i : _requests) {
+      auto req = _requests_factory->make(i);
+      names.emplace_back(req ? req->name() : std::to_string(i));
+    }
+    names.insert(names.end(), _metric_names.begin(), _metric_names.end());
+    return names;
+  }
+
+  /**
+   * @brief Exported value of a column (see column_names) for a generation, NaN if it was not recorded.
+   */
+  [[nodiscard]] double value(size_t generation, size_t column) const
+  {
+    if (generation >= _generation) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (column < _requests.size()) {
+      return double(_statistics(Eigen::Index(generation), Eigen::Index(column)));
+    }
+    const auto& values = _metrics[column - _requests.size()];
+    return generation < values.size() ? values[generation] : std::numeric_limits<double>::quiet_NaN();
+  }
+
   void write(std::ofstream& ofs, char sep)
   {
     write_headers(ofs, sep);
@@ -141,6 +233,13 @@ public:
         if (req) ofs << sep;
         ofs << _statistics(gen, req);
       }
+      // Counter-like metrics are large integers, written in full
+      const auto precision = ofs.precision(15);
+      for (const auto& values : _metrics) {
+        ofs << sep;
+        if (gen < values.size() && !std::isnan(values[gen])) ofs << values[gen];
+      }
+      ofs.precision(precision);
       ofs << '\n';
     }
   }
@@ -153,6 +252,19 @@ public:
     return _evaluation_count.load();
   }
 
+  /**
+   * @brief Restarts the clock of elapsed_time, the runner starts it with the run.
+   */
+  void start_clock()
+  {
+    _start_time = std::chrono::steady_clock::now();
+  }
+
+  [[nodiscard]] std::chrono::steady_clock::duration elapsed_time() const
+  {
+    return std::chrono::steady_clock::now() - _start_time;
+  }
+
   explicit evolution_statistics(
           Eigen::Index maximum_generations,
           vector<int> requests = vector < int > {
@@ -169,11 +281,15 @@ public:
 protected:
   size_t _generation{0};
   std::atomic_size_t _evaluation_count{0UL};
+  std::chrono::steady_clock::time_point _start_time{std::chrono::steady_clock::now()};
   Eigen::MatrixX<F> _statistics;
   vector<int> _requests;
 
 private:
   std::unique_ptr<statistics_requests_factory<F>> _requests_factory{std::make_unique<statistics_requests_factory<F>>()};
+  Eigen::VectorX<F> _fitness;
+  vector<string> _metric_names;
+  vector<vector<double>> _metrics;
 
   void write_headers(std::ofstream& ofs, char sep)
   {
@@ -189,6 +305,9 @@ private:
         ofs << req->name();
       }
     }
+    for (const auto& name : _metric_names) {
+      ofs << sep << name;
+    }
     ofs << '\n';
   }
 };
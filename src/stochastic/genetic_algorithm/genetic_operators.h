@@ -6,17 +6,49 @@
 #include <algorithm>
 #include <random>
 #include "base_individual.h"
+#include "vectorized_random.h"
 
 namespace minimacore::genetic_algorithm {
 
 
-template<floating_point_type F>
+template<floating_point_type F, int Dim_V = dynamic_dimension>
 class base_crossover {
 public:
   explicit base_crossover(size_t seed = 0) : _seed(seed)
   {}
   
-  virtual genome_t<F> operator()(const base_individual<F>& a, const base_individual<F>& b) const = 0;
+  virtual genome_t<F, Dim_V>
+  operator()(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b) const = 0;
+  
+  /**
+   * @brief Writes the offspring genome into an existing buffer, which is only reallocated if its size differs.
+   */
+  virtual void apply(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b,
+                     genome_t<F, Dim_V>& result) const
+  {
+    result = (*this)(a, b);
+  }
+  
+  /**
+   * @brief Breeds a whole block of offspring: column i of `result` is bred from the columns i of `a` and `b`. The
+   * result must already have the shape of the parents. The default implementation breeds column by column.
+   */
+  virtual void apply_batch(const genome_batch_t<F, Dim_V>& a, const genome_batch_t<F, Dim_V>& b,
+                           genome_batch_t<F, Dim_V>& result) const
+  {
+    if (a.cols() == 0) {
+      return;
+    }
+    base_individual<F, Dim_V> parent_a(a.col(0), 0);
+    base_individual<F, Dim_V> parent_b(b.col(0), 0);
+    genome_t<F, Dim_V> offspring(a.col(0));
+    for (Eigen::Index i = 0; i < a.cols(); i++) {
+      parent_a.genome() = a.col(i);
+      parent_b.genome() = b.col(i);
+      apply(parent_a, parent_b, offspring);
+      result.col(i) = offspring;
+    }
+  }
   
   virtual ~base_crossover() = default;
 
@@ -36,52 +68,133 @@ private:
   size_t _seed{0};
 };
 
-template<floating_point_type F>
-class uniform_linear_crossover : public base_crossover<F> {
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class uniform_linear_crossover : public base_crossover<F, Dim_V> {
 public:
-  genome_t<F> operator()(const base_individual<F>& a, const base_individual<F>& b) const override
+  genome_t<F, Dim_V> operator()(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b) const override
+  {
+    genome_t<F, Dim_V> result;
+    apply(a, b, result);
+    return result;
+  };
+  
+  void apply(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b,
+             genome_t<F, Dim_V>& result) const override
   {
     std::uniform_real_distribution<F> distribution(-1., 1.);
     auto gen = this->make_generator();
     F factor = _alpha * distribution(gen);
-    auto midpoint = (a.genome() + b.genome()) / 2.;
-    auto difference = b.genome() - midpoint;
-    return midpoint + factor * difference;
-  };
+    result.noalias() = (a.genome() + b.genome()) / 2.;
+    result += factor * (b.genome() - result);
+  }
   
-  explicit uniform_linear_crossover(F alpha, size_t seed = 0) : base_crossover<F>(seed), _alpha(alpha)
+  /**
+   * @brief Draws one blend factor per offspring and blends every column in a single fused expression.
+   */
+  void apply_batch(const genome_batch_t<F, Dim_V>& a, const genome_batch_t<F, Dim_V>& b,
+                   genome_batch_t<F, Dim_V>& result) const override
+  {
+    Eigen::Array<F, 1, Eigen::Dynamic> factors(a.cols());
+    auto& gen = thread_generator<uniform_linear_crossover, F>(this->seed());
+    gen.uniform(factors, -_alpha, _alpha);
+    result.array() = (a.array() + b.array()) * F(0.5) + ((b.array() - a.array()) * F(0.5)).rowwise() * factors;
+  }
+  
+  explicit uniform_linear_crossover(F alpha, size_t seed = 0) : base_crossover<F, Dim_V>(seed), _alpha(alpha)
   {}
 
 private:
   F _alpha;
 };
 
-template<floating_point_type F>
-class uniform_voluminal_crossover : public base_crossover<F> {
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class uniform_voluminal_crossover : public base_crossover<F, Dim_V> {
 public:
-  genome_t<F> operator()(const base_individual<F>& a, const base_individual<F>& b) const override
+  genome_t<F, Dim_V> operator()(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b) const override
   {
-    std::uniform_real_distribution<F> distribution(-1., 1.);
-    auto gen = this->make_generator();
-    genome_t<F> result = (a.genome() + b.genome()) / 2.;
-    for (long i = 0; i < result.size(); i++) {
-      F factor = _alpha * distribution(gen);
-      result(i) = result(i) + (b.genome()(i) - result(i)) * factor;
-    }
+    genome_t<F, Dim_V> result;
+    apply(a, b, result);
     return result;
   };
   
-  explicit uniform_voluminal_crossover(F alpha, size_t seed = 0) : base_crossover<F>(seed), _alpha(alpha)
+  void apply(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b,
+             genome_t<F, Dim_V>& result) const override
+  {
+    result.resize(a.genome().size());
+    if (result.size() >= vectorized_gene_threshold) {
+      auto& gen = thread_generator<uniform_voluminal_crossover, F>(this->seed());
+      gen.uniform(result, -_alpha, _alpha);
+    } else {
+      std::uniform_real_distribution<F> distribution(-1., 1.);
+      auto gen = this->make_generator();
+      for (long i = 0; i < result.size(); i++) result(i) = _alpha * distribution(gen);
+    }
+    blend(a.genome(), b.genome(), result);
+  }
+  
+  void apply_batch(const genome_batch_t<F, Dim_V>& a, const genome_batch_t<F, Dim_V>& b,
+                   genome_batch_t<F, Dim_V>& result) const override
+  {
+    auto& gen = thread_generator<uniform_voluminal_crossover, F>(this->seed());
+    gen.uniform(result, -_alpha, _alpha);
+    blend(a, b, result);
+  }
+  
+  explicit uniform_voluminal_crossover(F alpha, size_t seed = 0) : base_crossover<F, Dim_V>(seed), _alpha(alpha)
   {}
 
 private:
+  /**
+   * @brief Replaces the blend factors held in `result` by the offspring: midpoint + factor * half the parent distance.
+   */
+  template<typename Matrix_T>
+  static void blend(const Matrix_T& a, const Matrix_T& b, Matrix_T& result)
+  {
+    result.array() = (a.array() + b.array()) * F(0.5) + (b.array() - a.array()) * F(0.5) * result.array();
+  }
+  
   F _alpha;
 };
 
-template<floating_point_type F>
+template<floating_point_type F, int Dim_V = dynamic_dimension>
 class base_mutation {
 public:
-  virtual genome_t<F> operator()(const base_individual<F>& individual) const = 0;
+  virtual genome_t<F, Dim_V> operator()(const base_individual<F, Dim_V>& individual) const = 0;
+  
+  /**
+   * @brief Writes the mutated genome into an existing buffer, which is only reallocated if its size differs.
+   */
+  virtual void apply(const base_individual<F, Dim_V>& individual, genome_t<F, Dim_V>& result) const
+  {
+    result = (*this)(individual);
+  }
+  
+  /**
+   * @brief Mutates a whole block: column i of `result` is the mutation of column i of `parents`. The result must already
+   * have the shape of the parents. The default implementation mutates column by column.
+   */
+  virtual void apply_batch(const genome_batch_t<F, Dim_V>& parents, genome_batch_t<F, Dim_V>& result) const
+  {
+    if (parents.cols() == 0) {
+      return;
+    }
+    base_individual<F, Dim_V> parent(parents.col(0), 0);
+    genome_t<F, Dim_V> offspring(parents.col(0));
+    for (Eigen::Index i = 0; i < parents.cols(); i++) {
+      parent.genome() = parents.col(i);
+      apply(parent, offspring);
+      result.col(i) = offspring;
+    }
+  }
+  
+  /**
+   * @brief Sparse form of apply: describes the mutation as the genes it changes rather than writing a whole genome.
+   * @return False if the operator has no sparse form, `delta` is then left untouched
+   */
+  virtual bool sample_delta(const base_individual<F, Dim_V>&, genome_delta<F>&) const
+  {
+    return false;
+  }
   
   [[nodiscard]] bool should_mutate() const
   {
@@ -118,40 +231,195 @@ private:
   F _rate;
 };
 
-template<floating_point_type F>
-class gaussian_mutation : public base_mutation<F> {
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class gaussian_mutation : public base_mutation<F, Dim_V> {
 public:
-  genome_t<F> operator()(const base_individual<F>& individual) const override
+  genome_t<F, Dim_V> operator()(const base_individual<F, Dim_V>& individual) const override
   {
+    genome_t<F, Dim_V> cpy;
+    apply(individual, cpy);
+    return cpy;
+  }
+  
+  void apply(const base_individual<F, Dim_V>& individual, genome_t<F, Dim_V>& result) const override
+  {
+    if (individual.genome().size() >= vectorized_gene_threshold) {
+      result.resize(individual.genome().size());
+      auto& gen = thread_generator<gaussian_mutation, F>(this->seed());
+      gen.normal(result, 0., _std_dev);
+      result += individual.genome();
+      return;
+    }
     std::normal_distribution<F> distribution(0., _std_dev);
-    genome_t<F> cpy(individual.genome());
+    result = individual.genome();
     auto gen = this->make_generator();
-    for (long i = 0; i < cpy.size(); i++) cpy(i) += distribution(gen);
-    return cpy;
+    for (long i = 0; i < result.size(); i++) result(i) += distribution(gen);
   }
   
-  gaussian_mutation(F rate, F std_dev, size_t seed = 0) : base_mutation<F>(rate, seed), _std_dev(std_dev)
+  void apply_batch(const genome_batch_t<F, Dim_V>& parents, genome_batch_t<F, Dim_V>& result) const override
+  {
+    auto& gen = thread_generator<gaussian_mutation, F>(this->seed());
+    gen.normal(result, 0., _std_dev);
+    result += parents;
+  }
+  
+  gaussian_mutation(F rate, F std_dev, size_t seed = 0) : base_mutation<F, Dim_V>(rate, seed), _std_dev(std_dev)
   {}
 
 private:
   F _std_dev;
 };
 
-template<floating_point_type F>
-class uniform_mutation : public base_mutation<F> {
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class uniform_mutation : public base_mutation<F, Dim_V> {
 public:
-  genome_t<F> operator()(const base_individual<F>& individual) const override
+  genome_t<F, Dim_V> operator()(const base_individual<F, Dim_V>& individual) const override
+  {
+    genome_t<F, Dim_V> cpy;
+    apply(individual, cpy);
+    return cpy;
+  }
+  
+  void apply(const base_individual<F, Dim_V>& individual, genome_t<F, Dim_V>& result) const override
   {
+    if (individual.genome().size() >= vectorized_gene_threshold) {
+      result.resize(individual.genome().size());
+      auto& gen = thread_generator<uniform_mutation, F>(this->seed());
+      gen.uniform(result, -_factor, _factor);
+      result += individual.genome();
+      return;
+    }
     std::uniform_real_distribution<F> distribution(-1., 1.);
-    genome_t<F> cpy(individual.genome());
+    result = individual.genome();
     auto gen = this->make_generator();
-    for (long i = 0; i < cpy.size(); i++) cpy(i) += distribution(gen) * _factor;
+    for (long i = 0; i < result.size(); i++) result(i) += distribution(gen) * _factor;
+  }
+  
+  void apply_batch(const genome_batch_t<F, Dim_V>& parents, genome_batch_t<F, Dim_V>& result) const override
+  {
+    auto& gen = thread_generator<uniform_mutation, F>(this->seed());
+    gen.uniform(result, -_factor, _factor);
+    result += parents;
+  }
+  
+  uniform_mutation(F rate, F factor, size_t seed = 0) : base_mutation<F, Dim_V>(rate, seed), _factor(factor)
+  {}
+
+private:
+  F _factor;
+};
+
+/**
+ * @brief Mutation touching every gene independently with probability `gene_rate`. The genes to mutate are found by
+ * geometric skip sampling (the gap to the next mutated gene is geometrically distributed), so the cost is proportional
+ * to the number of mutated genes rather than to the genome length. Derived classes provide the perturbation of a gene.
+ */
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class sparse_mutation : public base_mutation<F, Dim_V> {
+public:
+  genome_t<F, Dim_V> operator()(const base_individual<F, Dim_V>& individual) const override
+  {
+    genome_t<F, Dim_V> cpy;
+    apply(individual, cpy);
     return cpy;
   }
   
-  uniform_mutation(F rate, F factor, size_t seed = 0) : base_mutation<F>(rate, seed), _factor(factor)
+  void apply(const base_individual<F, Dim_V>& individual, genome_t<F, Dim_V>& result) const override
+  {
+    result = individual.genome();
+    mutate_in_place(result);
+  }
+  
+  void apply_batch(const genome_batch_t<F, Dim_V>& parents, genome_batch_t<F, Dim_V>& result) const override
+  {
+    result = parents;
+    auto gen = this->make_generator();
+    for (Eigen::Index column = 0; column < result.cols(); column++) {
+      for_each_mutated_gene(result.rows(), gen, [&](Eigen::Index gene) { result(gene, column) += perturbation(gen); });
+    }
+  }
+  
+  bool sample_delta(const base_individual<F, Dim_V>& individual, genome_delta<F>& delta) const override
+  {
+    delta.clear();
+    auto gen = this->make_generator();
+    for_each_mutated_gene(individual.genome_size(), gen, [&](Eigen::Index gene) {
+      delta.indices.push_back(gene);
+      delta.values.push_back(individual.gene(gene) + perturbation(gen));
+    });
+    return true;
+  }
+  
+  /**
+   * @brief Mutates the genome without copying it, in O(number of mutated genes).
+   */
+  void mutate_in_place(genome_t<F, Dim_V>& genome) const
+  {
+    auto gen = this->make_generator();
+    for_each_mutated_gene(genome.size(), gen, [&](Eigen::Index gene) { genome(gene) += perturbation(gen); });
+  }
+  
+  [[nodiscard]] F gene_rate() const
+  {
+    return _gene_rate;
+  }
+
+protected:
+  sparse_mutation(F rate, F gene_rate, size_t seed) : base_mutation<F, Dim_V>(rate, seed), _gene_rate(gene_rate)
+  {}
+  
+  virtual F perturbation(std::mt19937_64& gen) const = 0;
+
+private:
+  template<typename Visitor_T>
+  void for_each_mutated_gene(Eigen::Index size, std::mt19937_64& gen, Visitor_T&& visit) const
+  {
+    if (_gene_rate <= 0) {
+      return;
+    }
+    if (_gene_rate >= 1) {
+      for (Eigen::Index gene = 0; gene < size; gene++) visit(gene);
+      return;
+    }
+    std::geometric_distribution<Eigen::Index> skip(_gene_rate);
+    for (Eigen::Index gene = skip(gen); gene < size; gene += 1 + skip(gen)) {
+      visit(gene);
+    }
+  }
+  
+  F _gene_rate;
+};
+
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class sparse_gaussian_mutation : public sparse_mutation<F, Dim_V> {
+public:
+  sparse_gaussian_mutation(F rate, F gene_rate, F std_dev, size_t seed = 0)
+          : sparse_mutation<F, Dim_V>(rate, gene_rate, seed), _std_dev(std_dev)
   {}
 
+protected:
+  F perturbation(std::mt19937_64& gen) const override
+  {
+    return std::normal_distribution<F>(0., _std_dev)(gen);
+  }
+
+private:
+  F _std_dev;
+};
+
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class sparse_uniform_mutation : public sparse_mutation<F, Dim_V> {
+public:
+  sparse_uniform_mutation(F rate, F gene_rate, F factor, size_t seed = 0)
+          : sparse_mutation<F, Dim_V>(rate, gene_rate, seed), _factor(factor)
+  {}
+
+protected:
+  F perturbation(std::mt19937_64& gen) const override
+  {
+    return std::uniform_real_distribution<F>(-_factor, _factor)(gen);
+  }
+
 private:
   F _factor;
 };
@@ -0,0 +1,60 @@
+
+#ifndef MINIMACORE_INDIVIDUAL_POOL_H
+#define MINIMACORE_INDIVIDUAL_POOL_H
+
+#include "base_individual.h"
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Free-list of individuals owned by a runner. Individuals that are no longer referenced outside the pool are
+   * handed out again together with their genome and fitness buffers, so a generation in steady state does not allocate
+   * individuals. The pool is not thread-safe and must only be used from the thread driving the generations.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class individual_pool {
+  public:
+    individual_ptr<Fp_T, Dim_V> acquire(Eigen::Index genome_size, long objective_count) {
+      if (_free.empty()) {
+        return std::make_shared<base_individual<Fp_T, Dim_V>>(genome_t<Fp_T, Dim_V>::Zero(genome_size),
+                                                              objective_count);
+      }
+      individual_ptr<Fp_T, Dim_V> individual = std::move(_free.back());
+      _free.pop_back();
+      individual->reset(genome_size, objective_count);
+      return individual;
+    }
+
+    /**
+     * @brief Returns the individual to the pool if nothing else references it, otherwise it is simply dropped.
+     */
+    void release(individual_ptr<Fp_T, Dim_V> &&individual) {
+      if (individual && individual.use_count() == 1) {
+        _free.emplace_back(std::move(individual));
+      }
+      individual.reset();
+    }
+
+    /**
+     * @brief Releases every individual of the candidate set and clears it, keeping its capacity.
+     */
+    void reclaim(population_t<Fp_T, Dim_V> &candidates) {
+      for (auto &individual : candidates) {
+        release(std::move(individual));
+      }
+      candidates.clear();
+    }
+
+    void reserve(size_t count) {
+      _free.reserve(count);
+    }
+
+    [[nodiscard]] size_t available() const {
+      return _free.size();
+    }
+
+  private:
+    population_t<Fp_T, Dim_V> _free;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_INDIVIDUAL_POOL_H
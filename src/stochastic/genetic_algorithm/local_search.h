@@ -0,0 +1,203 @@
+
+#ifndef MINIMACORE_LOCAL_SEARCH_H
+#define MINIMACORE_LOCAL_SEARCH_H
+
+#include "base_individual.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+namespace minimacore::genetic_algorithm {
+
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class base_local_search {
+  public:
+    /**
+     * @brief Evaluates the individual in place and returns its overall fitness (NaN if the evaluation failed).
+     */
+    using evaluator_t = std::function<Fp_T(base_individual<Fp_T, Dim_V> &)>;
+
+    /**
+     * @brief Refines the individual in place. The individual is only replaced by a candidate with a strictly better
+     * fitness, so a refinement can never make an elite worse.
+     * @param individual An evaluated individual
+     * @param evaluate Evaluation callback, every call counts as one evaluation
+     * @return The number of evaluations spent
+     */
+    virtual size_t operator()(base_individual<Fp_T, Dim_V> &individual, const evaluator_t &evaluate) const = 0;
+
+    [[nodiscard]] size_t budget() const {
+      return _budget;
+    }
+
+    explicit base_local_search(size_t budget) : _budget(budget) {}
+
+    base_local_search(const base_local_search &) = delete;
+    base_local_search(base_local_search &&) = delete;
+    base_local_search &operator=(const base_local_search &) = delete;
+    base_local_search &operator=(base_local_search &&) = delete;
+    virtual ~base_local_search() = default;
+
+  protected:
+    static Fp_T comparable(Fp_T fitness) {
+      return std::isnan(fitness) ? std::numeric_limits<Fp_T>::infinity() : fitness;
+    }
+
+  private:
+    size_t _budget{0};
+  };
+
+  /**
+   * @brief Compass (coordinate) search: probes +/- step along every gene, moves on the first improvement and contracts
+   * the step when no direction improves.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class coordinate_search : public base_local_search<Fp_T, Dim_V> {
+    using base = base_local_search<Fp_T, Dim_V>;
+
+  public:
+    size_t operator()(base_individual<Fp_T, Dim_V> &individual,
+                      const typename base::evaluator_t &evaluate) const override {
+      size_t evaluations{0};
+      Fp_T step = _initial_step;
+      Fp_T best = base::comparable(individual.overall_fitness());
+      base_individual<Fp_T, Dim_V> trial(individual);
+      while (evaluations < this->budget() && step > _minimum_step) {
+        bool improved = false;
+        for (long gene = 0; gene < individual.genome().size() && evaluations < this->budget(); gene++) {
+          for (const Fp_T direction : {Fp_T(1), Fp_T(-1)}) {
+            trial.genome() = individual.genome();
+            trial.genome()(gene) += direction * step;
+            const Fp_T fitness = base::comparable(evaluate(trial));
+            evaluations++;
+            if (fitness < best) {
+              best = fitness;
+              individual = trial;
+              improved = true;
+              break;
+            }
+            if (evaluations >= this->budget()) {
+              break;
+            }
+          }
+        }
+        if (!improved) {
+          step *= _contraction;
+        }
+      }
+      return evaluations;
+    }
+
+    coordinate_search(Fp_T initial_step, size_t budget, Fp_T contraction = 0.5, Fp_T minimum_step = 1E-8)
+        : base(budget), _initial_step(initial_step), _contraction(contraction), _minimum_step(minimum_step) {}
+
+  private:
+    Fp_T _initial_step;
+    Fp_T _contraction;
+    Fp_T _minimum_step;
+  };
+
+  /**
+   * @brief Nelder-Mead downhill simplex started from an axis-aligned simplex around the individual.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class nelder_mead : public base_local_search<Fp_T, Dim_V> {
+    using base = base_local_search<Fp_T, Dim_V>;
+
+  public:
+    size_t operator()(base_individual<Fp_T, Dim_V> &individual,
+                      const typename base::evaluator_t &evaluate) const override {
+      const long dimension = individual.genome().size();
+      size_t evaluations{0};
+      vector<base_individual<Fp_T, Dim_V>> simplex(dimension + 1, individual);
+      vector<Fp_T> fitness(dimension + 1, base::comparable(individual.overall_fitness()));
+      for (long i = 0; i < dimension && evaluations < this->budget(); i++) {
+        simplex[i + 1].genome()(i) += _initial_step;
+        fitness[i + 1] = base::comparable(evaluate(simplex[i + 1]));
+        evaluations++;
+      }
+
+      vector<size_t> order(simplex.size());
+      base_individual<Fp_T, Dim_V> reflected(individual);
+      base_individual<Fp_T, Dim_V> candidate(individual);
+      genome_t<Fp_T, Dim_V> centroid = genome_t<Fp_T, Dim_V>::Zero(dimension);
+      auto try_point = [&](base_individual<Fp_T, Dim_V> &point, Fp_T coefficient,
+                           const base_individual<Fp_T, Dim_V> &worst) {
+        point.genome() = centroid + coefficient * (worst.genome() - centroid);
+        evaluations++;
+        return base::comparable(evaluate(point));
+      };
+
+      while (evaluations < this->budget()) {
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::sort(order, [&fitness](size_t a, size_t b) { return fitness[a] < fitness[b]; });
+        const size_t best = order.front();
+        const size_t worst = order.back();
+        const size_t second_worst = order[order.size() - 2];
+        if (std::abs(fitness[worst] - fitness[best]) <= _tolerance) {
+          break;
+        }
+
+        centroid.setZero();
+        for (size_t i = 0; i + 1 < order.size(); i++) {
+          centroid += simplex[order[i]].genome();
+        }
+        centroid /= Fp_T(dimension);
+
+        const Fp_T reflected_fitness = try_point(reflected, -1., simplex[worst]);
+        if (reflected_fitness < fitness[best] && evaluations < this->budget()) {
+          const Fp_T expanded_fitness = try_point(candidate, -2., simplex[worst]);
+          if (expanded_fitness < reflected_fitness) {
+            simplex[worst] = candidate;
+            fitness[worst] = expanded_fitness;
+          } else {
+            simplex[worst] = reflected;
+            fitness[worst] = reflected_fitness;
+          }
+          continue;
+        }
+        if (reflected_fitness < fitness[second_worst]) {
+          simplex[worst] = reflected;
+          fitness[worst] = reflected_fitness;
+          continue;
+        }
+        if (evaluations >= this->budget()) {
+          break;
+        }
+        const Fp_T contracted_fitness = try_point(candidate, 0.5, simplex[worst]);
+        if (contracted_fitness < fitness[worst]) {
+          simplex[worst] = candidate;
+          fitness[worst] = contracted_fitness;
+          continue;
+        }
+        // Shrink every vertex towards the best one
+        for (size_t i = 0; i < simplex.size() && evaluations < this->budget(); i++) {
+          if (i != best) {
+            simplex[i].genome() = simplex[best].genome() + 0.5 * (simplex[i].genome() - simplex[best].genome());
+            fitness[i] = base::comparable(evaluate(simplex[i]));
+            evaluations++;
+          }
+        }
+      }
+
+      const auto best = std::distance(fitness.begin(), std::ranges::min_element(fitness));
+      if (fitness[best] < base::comparable(individual.overall_fitness())) {
+        individual = simplex[best];
+      }
+      return evaluations;
+    }
+
+    nelder_mead(Fp_T initial_step, size_t budget, Fp_T tolerance = 1E-10)
+        : base(budget), _initial_step(initial_step), _tolerance(tolerance) {}
+
+  private:
+    Fp_T _initial_step;
+    Fp_T _tolerance;
+  };
+
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using local_search_ptr = unique_ptr<base_local_search<Fp_T, Dim_V>>;
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_LOCAL_SEARCH_H
@@ -0,0 +1,121 @@
+
+#ifndef MINIMACORE_MAPPED_DATASET_H
+#define MINIMACORE_MAPPED_DATASET_H
+
+#include "base_individual.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mapped_file.h>
+#include <string>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Read-only, memory-mapped columnar dataset. The file starts with a 64-byte header:
+   *
+   *   char[8] magic "MMCDAT01", uint32 scalar size, uint32 version, uint64 row count, uint64 column count, padding
+   *
+   * followed by the columns one after the other (row count scalars each), in native byte order. The mapping is shared
+   * by every thread reading the dataset, so evaluations do not hold copies of the data; pages are loaded on demand.
+   */
+  template <floating_point_type Fp_T> class mapped_dataset {
+  public:
+    using column_t = Eigen::Map<const Eigen::Vector<Fp_T, Eigen::Dynamic>>;
+    using block_t = Eigen::Map<const Eigen::Matrix<Fp_T, Eigen::Dynamic, Eigen::Dynamic>, 0, Eigen::OuterStride<>>;
+
+    static constexpr std::uint32_t version = 1;
+
+    [[nodiscard]] bool is_open() const {
+      return _file.is_open();
+    }
+
+    [[nodiscard]] size_t rows() const {
+      return is_open() ? header().rows : 0;
+    }
+
+    [[nodiscard]] size_t columns() const {
+      return is_open() ? header().columns : 0;
+    }
+
+    [[nodiscard]] column_t column(size_t index) const {
+      return column_t(data() + index * rows(), Eigen::Index(rows()));
+    }
+
+    /**
+     * @brief Rows [first, first + count) of every column, as a count x columns matrix.
+     */
+    [[nodiscard]] block_t block(size_t first, size_t count) const {
+      return block_t(data() + first, Eigen::Index(count), Eigen::Index(columns()), Eigen::OuterStride<>(rows()));
+    }
+
+    /**
+     * @brief Asks the system to load rows [first, first + count) of every column ahead of their use.
+     */
+    void prefetch(size_t first, size_t count) const {
+      for (size_t i = 0; i < columns(); i++) {
+        const size_t offset = data_offset + (i * rows() + first) * sizeof(Fp_T);
+        _file.advise(offset, count * sizeof(Fp_T), mapped_file::access_hint::WILL_NEED);
+      }
+    }
+
+    /**
+     * @brief Writes a dataset file from a rows x columns matrix.
+     * @return false if the file could not be written
+     */
+    static bool write(const std::string &path, const Eigen::Matrix<Fp_T, Eigen::Dynamic, Eigen::Dynamic> &data) {
+      std::ofstream stream(path, std::ios::binary | std::ios::out | std::ios::trunc);
+      if (!stream.is_open()) {
+        return false;
+      }
+      header_t header{{}, sizeof(Fp_T), version, std::uint64_t(data.rows()), std::uint64_t(data.cols()), {}};
+      std::memcpy(header.magic, magic, sizeof(magic));
+      stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      // Eigen matrices are column-major by default, which is the file layout
+      stream.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size() * sizeof(Fp_T)));
+      return stream.good();
+    }
+
+    /**
+     * @brief Maps the dataset for reading. The dataset is closed if the file is missing, is not a dataset, or stores
+     * another scalar type.
+     */
+    explicit mapped_dataset(const std::string &path) : _file(mapped_file::open_read_only(path)) {
+      if (is_open() && (_file.size() < data_offset || std::memcmp(header().magic, magic, sizeof(magic)) != 0 ||
+                        header().scalar_size != sizeof(Fp_T) ||
+                        _file.size() < data_offset + header().rows * header().columns * sizeof(Fp_T))) {
+        _file.close();
+      }
+    }
+
+  private:
+    static constexpr char magic[8] = {'M', 'M', 'C', 'D', 'A', 'T', '0', '1'};
+
+    struct header_t {
+      char magic[8];
+      std::uint32_t scalar_size;
+      std::uint32_t version;
+      std::uint64_t rows;
+      std::uint64_t columns;
+      std::byte padding[32];
+    };
+
+    static_assert(sizeof(header_t) == 64);
+
+    static constexpr size_t data_offset = sizeof(header_t);
+
+    [[nodiscard]] const header_t &header() const {
+      return *reinterpret_cast<const header_t *>(_file.data());
+    }
+
+    [[nodiscard]] const Fp_T *data() const {
+      return reinterpret_cast<const Fp_T *>(_file.data() + data_offset);
+    }
+
+    // Mutable for the access hints only, the mapping is read-only
+    mutable mapped_file _file;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_MAPPED_DATASET_H
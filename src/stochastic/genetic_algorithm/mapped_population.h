@@ -0,0 +1,444 @@
+
+#ifndef MINIMACORE_MAPPED_POPULATION_H
+#define MINIMACORE_MAPPED_POPULATION_H
+
+#include "base_individual.h"
+#include "evolution_statistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mapped_file.h>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+#ifdef __has_include
+#if __has_include(<execution>)
+#include <execution>
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201603L
+#define HAS_EXECUTION_POLICIES 1
+#endif
+#endif
+#endif
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Population stored in a memory-mapped file, for populations (or histories) larger than the memory. The file
+   * holds a small header, the fitness block (one column of objectives per individual) and the genome block (one column
+   * per individual), so both can be streamed sequentially in chunks.
+   *
+   * A mapped population is evolved on the file by evolve, with the operators of a setup: evaluation and statistics
+   * stream over the file in chunks, and the selections run on the compact, in-memory fitness index, through genome-less
+   * stand-ins of the individuals. Only the parents are paged in. It can also archive the population of a runner
+   * (append).
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class mapped_population {
+  public:
+    using genome_map_t = Eigen::Map<genome_t<Fp_T, Dim_V>>;
+    using genome_block_t = Eigen::Map<genome_batch_t<Fp_T, Dim_V>>;
+    using fitness_block_t = Eigen::Map<Eigen::Matrix<Fp_T, Eigen::Dynamic, Eigen::Dynamic>>;
+
+    [[nodiscard]] bool is_open() const {
+      return _file.is_open();
+    }
+
+    [[nodiscard]] size_t size() const {
+      return is_open() ? header().size : 0;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+      return is_open() ? header().capacity : 0;
+    }
+
+    [[nodiscard]] Eigen::Index genome_size() const {
+      return is_open() ? Eigen::Index(header().genome_size) : 0;
+    }
+
+    [[nodiscard]] Eigen::Index objective_count() const {
+      return is_open() ? Eigen::Index(header().objective_count) : 0;
+    }
+
+    genome_map_t genome(size_t index) {
+      return genome_map_t(genome_data(index), genome_size());
+    }
+
+    genome_block_t genomes(size_t first, size_t count) {
+      return genome_block_t(genome_data(first), genome_size(), Eigen::Index(count));
+    }
+
+    fitness_block_t fitness(size_t first, size_t count) {
+      return fitness_block_t(fitness_data(first), objective_count(), Eigen::Index(count));
+    }
+
+    /**
+     * @brief Appends a copy of the individual, doubling the file when it is full.
+     */
+    bool push_back(const base_individual<Fp_T, Dim_V> &individual) {
+      if (!is_open() || individual.genome_size() != genome_size()) {
+        return false;
+      }
+      if (size() == capacity() && !reserve(std::max<size_t>(2 * capacity(), 1))) {
+        return false;
+      }
+      const size_t index = header().size++;
+      genome(index) = individual.genome();
+      fitness(index, 1) = individual.get_object_fitnesses();
+      return true;
+    }
+
+    /**
+     * @brief Appends every individual of an in-memory population.
+     */
+    bool append(const population_t<Fp_T, Dim_V> &population) {
+      if (size() + population.size() > capacity() && !reserve(std::max(2 * capacity(), size() + population.size()))) {
+        return false;
+      }
+      return std::ranges::all_of(population, [this](const auto &individual) { return push_back(*individual); });
+    }
+
+    bool resize(size_t size) {
+      if (!is_open()) {
+        return false;
+      }
+      if (size > capacity() && !reserve(size)) {
+        return false;
+      }
+      header().size = size;
+      return true;
+    }
+
+    void clear() {
+      if (is_open()) {
+        header().size = 0;
+      }
+    }
+
+    /**
+     * @brief Grows the file so it can hold `capacity` individuals. The genome block is moved, so maps taken before are
+     * invalidated.
+     */
+    bool reserve(size_t capacity) {
+      if (!is_open()) {
+        return false;
+      }
+      if (capacity <= this->capacity()) {
+        return true;
+      }
+      const header_t previous = header();
+      if (!_file.resize(file_size(previous.genome_size, previous.objective_count, capacity))) {
+        return false;
+      }
+      // The genome block starts after the fitness block, which grew: move it to its new offset
+      const size_t genome_bytes = previous.size * previous.genome_size * sizeof(Fp_T);
+      std::memmove(_file.data() + genome_offset(previous.objective_count, capacity),
+                   _file.data() + genome_offset(previous.objective_count, previous.capacity), genome_bytes);
+      header().capacity = capacity;
+      return true;
+    }
+
+    /**
+     * @brief Streams over the population in chunks of `chunk_size` individuals, calling
+     * `f(first, genome_block_t&, fitness_block_t&)` for each. The pages of the next chunk are requested while the current
+     * one is processed.
+     */
+    template <typename Function_T> void for_each_chunk(size_t chunk_size, Function_T &&f) {
+      for_each_chunk(0, chunk_size, std::forward<Function_T>(f));
+    }
+
+    /**
+     * @brief Streams over the individuals from `begin` on, see for_each_chunk.
+     */
+    template <typename Function_T> void for_each_chunk(size_t begin, size_t chunk_size, Function_T &&f) {
+      chunk_size = std::max<size_t>(chunk_size, 1);
+      _file.advise(mapped_file::access_hint::SEQUENTIAL);
+      for (size_t first = begin; first < size(); first += chunk_size) {
+        const size_t count = std::min(chunk_size, size() - first);
+        if (first + count < size()) {
+          prefetch(first + count, std::min(chunk_size, size() - first - count));
+        }
+        genome_block_t genomes = this->genomes(first, count);
+        fitness_block_t fitness = this->fitness(first, count);
+        f(first, genomes, fitness);
+      }
+      _file.advise(mapped_file::access_hint::NORMAL);
+    }
+
+    /**
+     * @brief Evaluates the individuals from `first` on chunk by chunk, in parallel within a chunk. `evaluation` receives
+     * a scratch individual holding the genome and writes its objectives, as the setup's evaluations do.
+     */
+    template <typename Evaluate_T> void evaluate(Evaluate_T &&evaluation, size_t chunk_size, size_t first = 0) {
+      vector<size_t> indices;
+      for_each_chunk(first, chunk_size, [&](size_t, genome_block_t &genomes, fitness_block_t &fitness) {
+        indices.resize(size_t(genomes.cols()));
+        std::iota(indices.begin(), indices.end(), 0);
+        std::for_each(
+#ifdef HAS_EXECUTION_POLICIES
+            std::execution::par,
+#endif
+            indices.begin(), indices.end(), [&](size_t i) {
+              base_individual<Fp_T, Dim_V> individual(genomes.col(Eigen::Index(i)), objective_count());
+              evaluation(individual);
+              fitness.col(Eigen::Index(i)) = individual.get_object_fitnesses();
+            });
+      });
+    }
+
+    /**
+     * @brief Overall fitness of every individual, streamed from the fitness block only.
+     */
+    void fitness_index(Eigen::VectorX<Fp_T> &result) {
+      result.resize(Eigen::Index(size()));
+      if (size() > 0) {
+        result = fitness(0, size()).colwise().sum().transpose();
+      }
+    }
+
+    [[nodiscard]] Eigen::VectorX<Fp_T> fitness_index() {
+      Eigen::VectorX<Fp_T> result;
+      fitness_index(result);
+      return result;
+    }
+
+    /**
+     * @brief Indices of the `count` best individuals, best first, selected on the fitness index alone.
+     */
+    vector<size_t> best(size_t count) {
+      const Eigen::VectorX<Fp_T> fitness = fitness_index();
+      vector<size_t> indices(size());
+      std::iota(indices.begin(), indices.end(), 0);
+      count = std::min(count, indices.size());
+      auto by_fitness = [&fitness](size_t a, size_t b) {
+        return fitness(Eigen::Index(a)) < fitness(Eigen::Index(b)) ||
+               (std::isnan(fitness(Eigen::Index(b))) && !std::isnan(fitness(Eigen::Index(a))));
+      };
+      std::partial_sort(indices.begin(), indices.begin() + long(count), indices.end(), by_fitness);
+      indices.resize(count);
+      return indices;
+    }
+
+    /**
+     * @brief Loads an individual into memory.
+     */
+    individual_ptr<Fp_T, Dim_V> load(size_t index) {
+      auto individual = std::make_shared<base_individual<Fp_T, Dim_V>>(genome(index), objective_count());
+      for (Eigen::Index objective = 0; objective < objective_count(); objective++) {
+        individual->set_objective_fitness(size_t(objective), fitness(index, 1)(objective, 0));
+      }
+      return individual;
+    }
+
+    /**
+     * @brief Registers the statistics of the population, computed on the fitness index alone.
+     */
+    void register_statistic(evolution_statistics<Fp_T> &statistics) {
+      fitness_index(_fitness);
+      statistics.register_statistic(_fitness);
+    }
+
+    /**
+     * @brief Runs the selection for reproduction of the setup on the fitness index alone.
+     * @return The indices of the selected individuals, in the order of the selection
+     */
+    template <typename Setup_T> vector<size_t> select_for_reproduction(const Setup_T &setup) {
+      make_stand_ins();
+      return indices_of(setup.select_for_reproduction(_stand_ins));
+    }
+
+    /**
+     * @brief Runs the selection for replacement of the setup on the fitness index alone, then moves the survivors to
+     * the front of the file, in their order, and drops the others.
+     * @return The number of survivors
+     */
+    template <typename Setup_T> size_t select_for_replacement(const Setup_T &setup) {
+      make_stand_ins();
+      setup.select_for_replacement(_stand_ins);
+      vector<size_t> survivors = indices_of(_stand_ins);
+      std::ranges::sort(survivors);
+      survivors.erase(std::unique(survivors.begin(), survivors.end()), survivors.end());
+      for (size_t i = 0; i < survivors.size(); i++) {
+        if (survivors[i] != i) {
+          genome(i) = genome(survivors[i]);
+          fitness(i, 1) = fitness(survivors[i], 1);
+        }
+      }
+      resize(survivors.size());
+      _stand_ins.clear();
+      return survivors.size();
+    }
+
+    /**
+     * @brief One generation evolved on the file, through the same steps as runner::run: selects the parents and the
+     * survivors on the fitness index, breeds offspring from the parents until the population reaches the population
+     * size of the setup, evaluates them chunk by chunk, and registers the statistics. The population must have been
+     * evaluated before the first generation.
+     * @return The number of objectives evaluated
+     */
+    template <typename Setup_T>
+    size_t evolve(const Setup_T &setup, evolution_statistics<Fp_T> &statistics, size_t chunk_size) {
+      population_t<Fp_T, Dim_V> parents;
+      for (size_t index : select_for_reproduction(setup)) {
+        parents.emplace_back(load(index));
+      }
+      select_for_replacement(setup);
+      const size_t first = size();
+      if (!parents.empty() && first < setup.population_size() && reserve(setup.population_size())) {
+        _offspring.resize(genome_size());
+        while (size() < setup.population_size()) {
+          const auto &parent = random_pick(parents);
+          if (setup.should_mutate()) {
+            setup.mutate(*parent, _offspring);
+          } else {
+            setup.cross(*parent, *random_pick(parents), _offspring);
+          }
+          const size_t index = header().size++;
+          genome(index) = _offspring;
+        }
+      }
+      std::atomic_size_t evaluations{0};
+      evaluate(
+          [&setup, &evaluations](base_individual<Fp_T, Dim_V> &individual) {
+            evaluations.fetch_add(setup.evaluate(individual), std::memory_order_relaxed);
+          },
+          chunk_size, first);
+      statistics.increment_evaluation_count(evaluations.load());
+      register_statistic(statistics);
+      return evaluations.load();
+    }
+
+    void flush() {
+      _file.flush();
+    }
+
+    /**
+     * @brief Creates (or truncates) a population file.
+     */
+    mapped_population(const std::string &path, Eigen::Index genome_size, Eigen::Index objective_count,
+                      size_t capacity)
+        : _file(path, file_size(size_t(genome_size), size_t(objective_count), std::max<size_t>(capacity, 1))) {
+      if (is_open()) {
+        header() = header_t{{}, sizeof(Fp_T), size_t(genome_size), size_t(objective_count),
+                            std::max<size_t>(capacity, 1), 0};
+        std::memcpy(header().magic, magic, sizeof(magic));
+      }
+    }
+
+    /**
+     * @brief Opens an existing population file. The population is closed if the file was not written with the same
+     * floating-point type and genome dimension.
+     */
+    explicit mapped_population(const std::string &path) : _file(path) {
+      if (is_open() && !valid()) {
+        _file.close();
+      }
+    }
+
+  private:
+    static constexpr char magic[8] = {'M', 'M', 'C', 'P', 'O', 'P', '0', '1'};
+
+    struct header_t {
+      char magic[8];
+      std::uint64_t scalar_size;
+      std::uint64_t genome_size;
+      std::uint64_t objective_count;
+      std::uint64_t capacity;
+      std::uint64_t size;
+    };
+
+    // Blocks start on cache-line boundaries
+    static constexpr size_t alignment = 64;
+
+    static constexpr size_t align(size_t offset) {
+      return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    static constexpr size_t fitness_offset() {
+      return align(sizeof(header_t));
+    }
+
+    static constexpr size_t genome_offset(size_t objective_count, size_t capacity) {
+      return align(fitness_offset() + objective_count * capacity * sizeof(Fp_T));
+    }
+
+    static constexpr size_t file_size(size_t genome_size, size_t objective_count, size_t capacity) {
+      return genome_offset(objective_count, capacity) + genome_size * capacity * sizeof(Fp_T);
+    }
+
+    /**
+     * @brief Whether the mapped file holds a population of this type, with blocks as large as its header claims.
+     */
+    [[nodiscard]] bool valid() const {
+      if (_file.size() < sizeof(header_t) || std::memcmp(header().magic, magic, sizeof(magic)) != 0 ||
+          header().scalar_size != sizeof(Fp_T) ||
+          (Dim_V != dynamic_dimension && header().genome_size != size_t(Dim_V)) || header().size > header().capacity) {
+        return false;
+      }
+      // Bounded by the file first, so that a corrupt header cannot overflow the block sizes
+      const size_t scalars = _file.size() / sizeof(Fp_T);
+      const header_t &h = header();
+      return h.capacity <= scalars && h.genome_size <= scalars && h.objective_count <= scalars &&
+             (h.capacity == 0 || h.genome_size + h.objective_count <= scalars / h.capacity) &&
+             _file.size() >= file_size(h.genome_size, h.objective_count, h.capacity);
+    }
+
+    header_t &header() {
+      return *reinterpret_cast<header_t *>(_file.data());
+    }
+
+    const header_t &header() const {
+      return *reinterpret_cast<const header_t *>(_file.data());
+    }
+
+    Fp_T *fitness_data(size_t index) {
+      return reinterpret_cast<Fp_T *>(_file.data() + fitness_offset()) + index * header().objective_count;
+    }
+
+    Fp_T *genome_data(size_t index) {
+      return reinterpret_cast<Fp_T *>(_file.data() + genome_offset(header().objective_count, header().capacity)) +
+             index * header().genome_size;
+    }
+
+    /**
+     * @brief Fills the stand-ins with the fitness index: one genome-less individual per individual of the file, which
+     * the selection operators rank without any genome being paged in. The stand-ins are kept across generations.
+     */
+    void make_stand_ins() {
+      fitness_index(_fitness);
+      while (_stand_in_storage.size() < size()) {
+        const auto &stand_in = _stand_in_storage.emplace_back(std::make_shared<base_individual<Fp_T, Dim_V>>(
+            genome_t<Fp_T, Dim_V>::Zero(Dim_V == dynamic_dimension ? 0 : Dim_V), 1));
+        _stand_in_index.emplace(stand_in.get(), _stand_in_storage.size() - 1);
+      }
+      for (size_t i = 0; i < size(); i++) {
+        _stand_in_storage[i]->set_objective_fitness(0, _fitness(Eigen::Index(i)));
+      }
+      _stand_ins.assign(_stand_in_storage.begin(), _stand_in_storage.begin() + long(size()));
+    }
+
+    vector<size_t> indices_of(const population_t<Fp_T, Dim_V> &stand_ins) const {
+      vector<size_t> indices;
+      indices.reserve(stand_ins.size());
+      for (const auto &stand_in : stand_ins) {
+        indices.push_back(_stand_in_index.at(stand_in.get()));
+      }
+      return indices;
+    }
+
+    void prefetch(size_t first, size_t count) {
+      const size_t offset = size_t(reinterpret_cast<std::byte *>(genome_data(first)) - _file.data());
+      _file.advise(offset, count * header().genome_size * sizeof(Fp_T), mapped_file::access_hint::WILL_NEED);
+    }
+
+    mapped_file _file;
+    Eigen::VectorX<Fp_T> _fitness;
+    genome_t<Fp_T, Dim_V> _offspring;
+    population_t<Fp_T, Dim_V> _stand_in_storage;
+    population_t<Fp_T, Dim_V> _stand_ins;
+    std::unordered_map<const base_individual<Fp_T, Dim_V> *, size_t> _stand_in_index;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_MAPPED_POPULATION_H
@@ -0,0 +1,181 @@
+
+#ifndef MINIMACORE_POPULATION_RECORDER_H
+#define MINIMACORE_POPULATION_RECORDER_H
+
+#include "base_individual.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Records the population history in a compact binary, columnar file. The file starts with a 64-byte header:
+   *
+   *   char[8] magic "MMCREC01", uint32 scalar size, uint32 version, uint64 genome size, uint64 objective count, padding
+   *
+   * followed by one block per recorded generation:
+   *
+   *   uint64 generation, uint64 individual count, the genomes gene by gene (genome size x count scalars), then the
+   *   objectives objective by objective (objective count x count scalars)
+   *
+   * in native byte order. record() only copies the population into a block; a background thread writes the blocks, so
+   * recording never waits on the disk. population_history.py (Rastrigin example) memory-maps the file from Python.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class population_recorder {
+    struct block_t {
+      std::uint64_t generation{0};
+      std::uint64_t count{0};
+      vector<Fp_T> data;
+    };
+
+  public:
+    static constexpr std::uint32_t version = 1;
+
+    [[nodiscard]] bool is_open() const {
+      return _stream.is_open();
+    }
+
+    /**
+     * @brief Number of generations recorded so far, which numbers the next generation recorded by record(population).
+     */
+    [[nodiscard]] std::uint64_t recorded() const {
+      std::lock_guard lock(_mutex);
+      return _recorded;
+    }
+
+    void record(const population_t<Fp_T, Dim_V> &population) {
+      record(population, recorded());
+    }
+
+    /**
+     * @brief Copies the population into a columnar block and queues it for the writer thread.
+     */
+    void record(const population_t<Fp_T, Dim_V> &population, std::uint64_t generation) {
+      if (!is_open()) {
+        return;
+      }
+      block_t block{generation, population.size(), take_buffer()};
+      const size_t count = population.size();
+      block.data.resize(count * size_t(_genome_size + _objective_count));
+      Fp_T *genomes = block.data.data();
+      Fp_T *objectives = genomes + count * size_t(_genome_size);
+      for (size_t i = 0; i < count; i++) {
+        const auto &genome = population[i]->genome();
+        const auto &fitness = population[i]->get_object_fitnesses();
+        for (Eigen::Index gene = 0; gene < _genome_size; gene++) {
+          genomes[size_t(gene) * count + i] = genome(gene);
+        }
+        for (Eigen::Index objective = 0; objective < _objective_count; objective++) {
+          objectives[size_t(objective) * count + i] = fitness(objective);
+        }
+      }
+      {
+        std::lock_guard lock(_mutex);
+        _queue.push_back(std::move(block));
+        _recorded++;
+      }
+      _work.notify_one();
+    }
+
+    /**
+     * @brief Blocks until every queued generation is written to the file.
+     */
+    void flush() {
+      std::unique_lock lock(_mutex);
+      _idle.wait(lock, [this]() { return _queue.empty() && !_writing; });
+      _stream.flush();
+    }
+
+    population_recorder(const std::string &path, Eigen::Index genome_size, Eigen::Index objective_count)
+        : _stream(path, std::ios::out | std::ios::binary | std::ios::trunc), _genome_size(genome_size),
+          _objective_count(objective_count) {
+      if (!is_open()) {
+        return;
+      }
+      char header[64]{};
+      const std::uint32_t scalar_size = sizeof(Fp_T);
+      const std::uint64_t sizes[2] = {std::uint64_t(genome_size), std::uint64_t(objective_count)};
+      std::memcpy(header, "MMCREC01", 8);
+      std::memcpy(header + 8, &scalar_size, sizeof(scalar_size));
+      std::memcpy(header + 12, &version, sizeof(version));
+      std::memcpy(header + 16, sizes, sizeof(sizes));
+      _stream.write(header, sizeof(header));
+      _writer = std::thread([this]() { write_loop(); });
+    }
+
+    population_recorder(const population_recorder &) = delete;
+    population_recorder(population_recorder &&) = delete;
+    population_recorder &operator=(const population_recorder &) = delete;
+    population_recorder &operator=(population_recorder &&) = delete;
+
+    ~population_recorder() {
+      {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+      }
+      _work.notify_one();
+      if (_writer.joinable()) {
+        _writer.join();
+      }
+    }
+
+  private:
+    vector<Fp_T> take_buffer() {
+      std::lock_guard lock(_mutex);
+      if (_buffers.empty()) {
+        return {};
+      }
+      vector<Fp_T> buffer = std::move(_buffers.back());
+      _buffers.pop_back();
+      return buffer;
+    }
+
+    void write_loop() {
+      std::unique_lock lock(_mutex);
+      while (true) {
+        _work.wait(lock, [this]() { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+          // Stopping with nothing left to write
+          _stream.flush();
+          return;
+        }
+        block_t block = std::move(_queue.front());
+        _queue.pop_front();
+        _writing = true;
+        lock.unlock();
+        const std::uint64_t header[2] = {block.generation, block.count};
+        _stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+        _stream.write(reinterpret_cast<const char *>(block.data.data()),
+                      std::streamsize(block.data.size() * sizeof(Fp_T)));
+        lock.lock();
+        _writing = false;
+        _buffers.push_back(std::move(block.data));
+        if (_queue.empty()) {
+          _idle.notify_all();
+        }
+      }
+    }
+
+    std::ofstream _stream;
+    Eigen::Index _genome_size;
+    Eigen::Index _objective_count;
+    mutable std::mutex _mutex;
+    std::condition_variable _work;
+    std::condition_variable _idle;
+    std::deque<block_t> _queue;
+    vector<vector<Fp_T>> _buffers;
+    std::uint64_t _recorded{0};
+    bool _stop{false};
+    bool _writing{false};
+    std::thread _writer;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_POPULATION_RECORDER_H
@@ -3,14 +3,20 @@
 #define MINIMACORE_RUNNER_H
 
 #include "base_evaluation.h"
+#include "individual_pool.h"
 #include "selection_operators.h"
 #include "setup.h"
+#include "static_setup.h"
 #include "termination_condition.h"
 
 #include <functional>
+#include <limits>
+#include <executor.h>
 #include <logger.h>
 #include <minimacore_concepts.h>
-#include <thread_pool.h>
+#include <numeric>
+#include <perf_counters.h>
+#include <tracer.h>
 
 #ifdef __has_include
 #if __has_include(<execution>)
@@ -28,19 +34,42 @@ namespace minimacore::genetic_algorithm {
   using time_point_t = std::chrono::time_point<clock_t>;
   using duration_t = std::chrono::duration<double, std::milli>;
 
-  template <floating_point_type Fp_T> class runner {
-    using evaluation_t = unique_ptr<base_evaluation<Fp_T>>;
-
+  /**
+   * @brief Genetic algorithm driver. The setup type decides how operators are dispatched: the default setup resolves
+   * them at run-time through their abstract bases, static_setup fixes them at compile time.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension, typename Setup_T = setup<Fp_T, Dim_V>>
+  class runner {
   public:
     enum class exit_flag : std::uint8_t { SUCCESS = 0, FAILURE };
 
     enum class state : std::uint8_t { WAITING = 0, RUNNING, PAUSING, PAUSED, STOPPING, STOPPED, DONE };
 
+    /**
+     * @brief Phases measured with hardware counters when the setup enables them. Their totals are recorded per
+     * generation as the statistics metrics `<phase>_<event>`, e.g. `evaluation_cycles`, and exported with the
+     * statistics. Variation counts the breeding of the offspring, evaluation sums every worker thread.
+     */
+    enum class profiling_phase : std::uint8_t { SELECTION = 0, VARIATION, EVALUATION, STATISTICS };
+
+    static constexpr std::array<const char *, 4> profiling_phase_names{"selection", "variation", "evaluation",
+                                                                       "statistics"};
+
+    /**
+     * @brief Longest wait on an evaluation between two checks of the budgets.
+     */
+    static constexpr std::chrono::milliseconds budget_poll_interval{1};
+
+    /**
+     * @brief Mean evaluation time below which evaluations are never split into nested reductions.
+     */
+    static constexpr std::chrono::microseconds nested_parallelism_threshold{100};
+
     void pause() {
       switch (_state) {
       case state::RUNNING:
         _state = state::PAUSING;
-        _log << logger::wrapped_uts_timestamp() << "Pause requested, sending signal...\n";
+        _log.info() << "Pause requested, sending signal...";
         break;
       default:
         break;
@@ -51,7 +80,7 @@ namespace minimacore::genetic_algorithm {
       switch (_state) {
       case state::PAUSING:
       case state::PAUSED:
-        _log << logger::wrapped_uts_timestamp() << "Resuming genetic algorithm...\n";
+        _log.info() << "Resuming genetic algorithm...";
         _state = state::RUNNING;
         break;
       default:
@@ -71,11 +100,11 @@ namespace minimacore::genetic_algorithm {
       }
     }
 
-    const shared_ptr<base_individual<Fp_T>> &get_best_individual() const {
+    const shared_ptr<base_individual<Fp_T, Dim_V>> &get_best_individual() const {
       return _best_individual;
     }
 
-    const shared_ptr<base_individual<Fp_T>> &get_individual_zero() const {
+    const shared_ptr<base_individual<Fp_T, Dim_V>> &get_individual_zero() const {
       return _individual_zero;
     }
 
@@ -95,33 +124,26 @@ namespace minimacore::genetic_algorithm {
       if (_state != state::WAITING) {
         return exit_flag::FAILURE;
       }
-      _start_time = std::chrono::high_resolution_clock::now();
-      _state = state::RUNNING;
-      _log << logger::wrapped_uts_timestamp() << "Starting genetic algorithm...\n";
+      start();
       initialize_individual_zero();
       if (!initialize_population()) {
         display_final_message(exit_flag::FAILURE);
         return exit_flag::FAILURE;
       }
-      _setup.run_iteration_callbacks();
-      _statistics.register_statistic(_population);
-      _setup.add_termination(std::make_unique<generation_termination<Fp_T>>(_setup.generations()));
-      while (std::none_of(
-#ifdef HAS_EXECUTION_POLICIES
-          std::execution::par_unseq,
-#endif
-
-          _setup.termination_conditions().begin(), _setup.termination_conditions().end(),
-          [this](auto &condition) { return (*condition)(_statistics); })) {
+      complete_initialization();
+      while (!terminated()) {
         switch (_state) {
         case state::RUNNING: {
-          auto reproduction_set = _setup.selection_for_reproduction()(_population);
-          _setup.selection_for_replacement()(_population);
-          fill_population(reproduction_set);
-          _statistics.register_statistic(_population);
-          update_best_individual();
-          _setup.run_iteration_callbacks();
-          _log << logger::wrapped_uts_timestamp() << "Generation " << _statistics.current_generation() << " complete\n";
+          MINIMACORE_TRACE_SCOPE("generation", "runner");
+          open_generation();
+          {
+            MINIMACORE_TRACE_SCOPE("fill_population", "runner");
+            fill_population(_reproduction_set);
+          }
+          recycle_previous_generation();
+          refine_elites();
+          race();
+          close_generation();
           break;
         }
         case state::PAUSING: {
@@ -136,6 +158,7 @@ namespace minimacore::genetic_algorithm {
           break;
         }
         case state::STOPPED: {
+          _setup.drain_async_callbacks();
           display_final_message(exit_flag::SUCCESS);
           return exit_flag::SUCCESS;
         }
@@ -144,151 +167,1061 @@ namespace minimacore::genetic_algorithm {
         }
       }
       _state = state::DONE;
+      _setup.drain_async_callbacks();
       display_final_message(exit_flag::SUCCESS);
       return exit_flag::SUCCESS;
     }
 
-    setup<Fp_T> &get_setup() {
+    /**
+     * @brief Candidates handed out by ask: their genomes as the columns of one contiguous matrix, and the individuals
+     * they belong to. A batch can be reused across asks; its buffer is only reallocated when it grows.
+     */
+    class candidate_batch {
+    public:
+      using genomes_t = Eigen::Map<const Eigen::Matrix<Fp_T, Dim_V, Eigen::Dynamic>>;
+
+      [[nodiscard]] size_t size() const {
+        return _individuals.size();
+      }
+
+      [[nodiscard]] bool empty() const {
+        return _individuals.empty();
+      }
+
+      [[nodiscard]] genomes_t genomes() const {
+        return genomes_t(_genomes.data(), _genome_size, Eigen::Index(size()));
+      }
+
+      [[nodiscard]] const population_t<Fp_T, Dim_V> &individuals() const {
+        return _individuals;
+      }
+
+    private:
+      friend class runner;
+
+      vector<Fp_T> _genomes;
+      Eigen::Index _genome_size{0};
+      population_t<Fp_T, Dim_V> _individuals;
+    };
+
+    /**
+     * @brief Step-wise alternative to run, for evaluations run by an external scheduler. Hands out up to `count`
+     * candidates to evaluate, whose objectives are returned with tell; between the two, the runner applies the
+     * selection, variation, statistics and termination of run. The first candidates form the initial population, the
+     * first of them having the initial genome (individual zero), then each generation hands out the offspring.
+     *
+     * Only the population slots not yet handed out are, so an empty batch means that the outstanding candidates must be
+     * told first, that the run is paused, or that it is finished. A batch still holding candidates is refused: it must
+     * be told before being asked again. Evaluation features of run (time limits, pruning, successive halving, racing,
+     * local search and surrogate screening) do not apply.
+     * @return The number of candidates handed out
+     */
+    size_t ask(size_t count, candidate_batch &batch) {
+      if (!batch.empty()) {
+        _log.warning() << "Asked with a batch of " << batch.size() << " candidates not told yet";
+        return 0;
+      }
+      if (_state == state::WAITING) {
+        start();
+        _stepping = true;
+      }
+      if (!_stepping || !open_step()) {
+        return 0;
+      }
+      count = std::min(count, _setup.population_size() - _population.size() - _outstanding);
+      for (size_t i = 0; i < count; i++) {
+        batch._individuals.emplace_back(_initialized ? breed(_reproduction_set) : initial_candidate());
+      }
+      _outstanding += count;
+      batch._genome_size = count > 0 ? batch._individuals.front()->genome_size() : 0;
+      batch._genomes.resize(size_t(batch._genome_size) * count);
+      for (size_t i = 0; i < count; i++) {
+        Eigen::Map<genome_t<Fp_T, Dim_V>>(batch._genomes.data() + i * size_t(batch._genome_size),
+                                          batch._genome_size) = batch._individuals[i]->genome();
+      }
+      return count;
+    }
+
+    candidate_batch ask(size_t count) {
+      candidate_batch batch;
+      ask(count, batch);
+      return batch;
+    }
+
+    /**
+     * @brief Returns the objectives of a batch handed out by ask, one column per candidate, and clears the batch.
+     * Candidates with a NaN objective are discarded, and their slots handed out again; individual zero is kept with
+     * its NaN fitness, as run does. During the initialization, the run fails (and finishes) once
+     * max_contiguous_failure_on_initialization candidates in a row failed. Once the population is full, the generation
+     * completes, and the run finishes if a termination condition is met.
+     * @return false, leaving the batch untouched, if the objectives are not one column of objective_count rows per
+     * candidate
+     */
+    bool tell(candidate_batch &batch,
+              const Eigen::Ref<const Eigen::Matrix<Fp_T, Eigen::Dynamic, Eigen::Dynamic>> &objectives) {
+      if (size_t(objectives.cols()) != batch.size() || size_t(objectives.rows()) != _objective_count) {
+        _log.error() << "Told " << objectives.rows() << "x" << objectives.cols() << " objectives for a batch of "
+                     << batch.size() << " candidates with " << _objective_count << " objectives";
+        return false;
+      }
+      for (size_t i = 0; i < batch.size(); i++) {
+        auto &individual = batch._individuals[i];
+        const bool zero = individual.get() == _zero_candidate;
+        _zero_candidate = zero ? nullptr : _zero_candidate;
+        _outstanding--;
+        for (size_t j = 0; j < _objective_count; j++) {
+          individual->set_objective_fitness(j, objectives(Eigen::Index(j), Eigen::Index(i)));
+        }
+        individual->reset_samples();
+        const bool failed = objectives.col(Eigen::Index(i)).hasNaN();
+        if (!failed) {
+          _statistics.increment_evaluation_count(_objective_count);
+        }
+        if (zero) {
+          _individual_zero = individual;
+          _log.info() << "Individual zero fitness: " << _individual_zero->overall_fitness();
+          if (failed) {
+            continue;
+          }
+        }
+        if (failed) {
+          _pool.release(std::move(individual));
+          _contiguous_failures++;
+          continue;
+        }
+        _contiguous_failures = 0;
+        _population.emplace_back(std::move(individual));
+      }
+      batch._individuals.clear();
+      if (!_initialized && _contiguous_failures >= _setup.max_contiguous_failure_on_initialization()) {
+        _log.warning() << "Failed to initialize population. Maximum contiguous failure reached: "
+                       << _setup.max_contiguous_failure_on_initialization();
+        _state = state::STOPPED;
+        _setup.drain_async_callbacks();
+        display_final_message(exit_flag::FAILURE);
+        return true;
+      }
+      if (_population.size() < _setup.population_size()) {
+        return true;
+      }
+      if (!_initialized) {
+        update_best_individual();
+        complete_initialization();
+        _initialized = true;
+      } else {
+        recycle_previous_generation();
+        close_generation();
+        _generation_open = false;
+      }
+      if (terminated()) {
+        _state = state::DONE;
+        _setup.drain_async_callbacks();
+        display_final_message(exit_flag::SUCCESS);
+      }
+      return true;
+    }
+
+    /**
+     * @brief True once a run driven by ask and tell is over.
+     */
+    [[nodiscard]] bool finished() const {
+      return _state == state::DONE || _state == state::STOPPED;
+    }
+
+    Setup_T &get_setup() {
       return _setup;
     }
 
-    const population_t<Fp_T> &get_population() const {
+    const population_t<Fp_T, Dim_V> &get_population() const {
       return _population;
     }
 
+    const evolution_statistics<Fp_T> &get_statistics() const {
+      return _statistics;
+    }
+
     [[nodiscard]] duration_t elapsed_time_ms() const {
       const auto duration = clock_t::now() - _start_time;
       return std::chrono::duration_cast<std::chrono::milliseconds>(duration);
     }
 
-    explicit runner(setup<Fp_T> s)
-        : _statistics(s.generations()), _setup(std::move(s)), _threads(_setup.get_thread_count()) {}
+    /**
+     * @brief Runs the evaluations on a pool of its own, with the setup thread count.
+     */
+    explicit runner(Setup_T s)
+        : _statistics(s.generations()), _setup(std::move(s)),
+          _owned_threads(std::make_unique<thread_pool>(_setup.get_thread_count())),
+          _owned_executor(std::make_unique<thread_pool_executor>(*_owned_threads)), _executor(_owned_executor.get()) {}
+
+    /**
+     * @brief Runs the evaluations on a pool shared with other runners (see sweep), in a lane of their own. The setup
+     * thread count is ignored.
+     */
+    runner(Setup_T s, thread_pool &threads)
+        : _statistics(s.generations()), _setup(std::move(s)),
+          _owned_executor(std::make_unique<thread_pool_executor>(threads)), _executor(_owned_executor.get()) {}
+
+    /**
+     * @brief Runs the evaluations on an executor owned by the caller, which must outlive the runner. The setup thread
+     * count is ignored.
+     */
+    runner(Setup_T s, base_executor &executor)
+        : _statistics(s.generations()), _setup(std::move(s)), _executor(&executor) {}
+
+    runner(const runner &) = delete;
+    runner &operator=(const runner &) = delete;
+
+    ~runner() {
+      // Abandoned evaluations still reference the runner, and a shared executor outlives it
+      for (auto &abandoned : _abandoned) {
+        abandoned.second.wait();
+      }
+    }
 
   private:
-    void display_final_message(exit_flag flag) {
-      _log << logger::wrapped_uts_timestamp() << "Optimization finished.\n"
-           << logger::wrapped_uts_timestamp() << "Total evaluations: " << _statistics.evaluation_count() << '\n'
-           << logger::wrapped_uts_timestamp() << "Total elapsed time: " << elapsed_time_ms().count() << "ms\n";
+    void start() {
+      _start_time = std::chrono::high_resolution_clock::now();
+      _statistics.start_clock();
+      _state = state::RUNNING;
+      if (tracer::enabled()) {
+        tracer::set_thread_name("runner");
+      }
+      _log.info() << "Starting genetic algorithm...";
+      _objective_count = _setup.objective_count();
+      collect_budgets();
+      _pool.reserve(_setup.population_size());
+      _previous_generation.reserve(_setup.population_size());
+      open_counters();
+      _setup.begin_generation(0, _setup.generations());
+    }
+
+    void complete_initialization() {
+      _setup.run_iteration_callbacks();
+      _statistics.register_statistic(_population);
+      record_counters();
+      _setup.publish_snapshot(_statistics.current_generation(), _population, _best_individual);
+      _setup.add_termination(std::make_unique<generation_termination<Fp_T>>(_setup.generations()));
     }
 
-    [[nodiscard]] size_t objective_count() const {
-      return std::accumulate(_setup.evaluations().begin(), _setup.evaluations().end(), 0,
-                             [](size_t i, const evaluation_t &eval) { return i + eval->objective_count(); });
+    [[nodiscard]] bool terminated() const {
+      return std::any_of(
+#ifdef HAS_EXECUTION_POLICIES
+          std::execution::par_unseq,
+#endif
+          _setup.termination_conditions().begin(), _setup.termination_conditions().end(),
+          [this](auto &condition) { return (*condition)(_statistics); });
     }
 
-    Fp_T evaluate(const individual_ptr<Fp_T> &individual) {
-      size_t counter = 0; // used to count objectives and align fitness values
-      for (auto &evaluation : _setup.evaluations()) {
-        counter = (*evaluation)(*individual, counter);
+    /**
+     * @brief Selects the parents of the generation and the survivors of the previous one.
+     */
+    void open_generation() {
+      if (_setup.begin_generation(_statistics.current_generation(), _setup.generations())) {
+        rescore_population();
+      }
+      _previous_generation.assign(_population.begin(), _population.end());
+      // Rejected offspring only carry a bound of their fitness: they neither reproduce nor survive
+      std::erase_if(_population, [](const auto &individual) { return individual->is_rejected(); });
+      {
+        MINIMACORE_TRACE_SCOPE("select_for_reproduction", "runner");
+        perf_phase_counters::scope counters = measure(profiling_phase::SELECTION);
+        _reproduction_set = _setup.select_for_reproduction(_population);
+      }
+      {
+        MINIMACORE_TRACE_SCOPE("select_for_replacement", "runner");
+        perf_phase_counters::scope counters = measure(profiling_phase::SELECTION);
+        _setup.select_for_replacement(_population);
+        _survival_threshold = survival_threshold();
+        _survivor_count = _population.size();
       }
-      _statistics.increment_evaluation_count(counter);
-      return individual->overall_fitness();
     }
 
-    void initialize_individual_zero() {
-      _log << logger::wrapped_uts_timestamp() << "Initializing individual zero\n";
-      _individual_zero =
-          std::make_shared<base_individual<Fp_T>>(_setup.get_genome_generator().initial_genome(), objective_count());
-      evaluate(_individual_zero);
-      _log << logger::wrapped_uts_timestamp() << "Individual zero fitness: " << _individual_zero->overall_fitness()
-           << '\n';
-    }
-
-    bool initialize_individual(const individual_ptr<Fp_T> &individual) {
-      size_t contiguous_failures = 0;
-      _setup.get_genome_generator()(individual);
-      while (std::isnan(evaluate(individual)) &&
-             contiguous_failures < _setup.max_contiguous_failure_on_initialization()) {
+    /**
+     * @brief Individuals that did not survive and are no longer parents are recycled for the next generation.
+     */
+    void recycle_previous_generation() {
+      _reproduction_set.clear();
+      _pool.reclaim(_previous_generation);
+    }
+
+    /**
+     * @brief Registers the statistics of the full population and runs the callbacks.
+     */
+    void close_generation() {
+      {
+        MINIMACORE_TRACE_SCOPE("statistics", "runner");
+        perf_phase_counters::scope counters = measure(profiling_phase::STATISTICS);
+        register_statistic();
+        update_best_individual();
+      }
+      record_counters();
+      record_surrogate_error();
+      record_abandoned_evaluations();
+      record_pruned_evaluations();
+      record_promotions();
+      record_racing_evaluations();
+      {
+        MINIMACORE_TRACE_SCOPE("callbacks", "runner");
+        _setup.run_iteration_callbacks();
+        _setup.publish_snapshot(_statistics.current_generation(), _population, _best_individual);
+      }
+      _log.info() << "Generation " << _statistics.current_generation() << " complete";
+    }
+
+    /**
+     * @brief Moves a stepped run to the point where candidates can be handed out: opens the next generation once the
+     * previous one completed, unless the run is paused or stopped.
+     * @return false if no candidate can be handed out
+     */
+    bool open_step() {
+      switch (_state) {
+      case state::RUNNING:
+        break;
+      case state::PAUSING:
+        _state = state::PAUSED;
+        return false;
+      case state::STOPPING:
+        _state = state::STOPPED;
+        _setup.drain_async_callbacks();
+        display_final_message(exit_flag::SUCCESS);
+        return false;
+      default:
+        return false;
+      }
+      if (!_initialized || _generation_open) {
+        return true;
+      }
+      MINIMACORE_TRACE_SCOPE("generation", "runner");
+      open_generation();
+      _generation_open = true;
+      return true;
+    }
+
+    /**
+     * @brief Candidate of the initial population: individual zero first, then genomes of the generator.
+     */
+    individual_ptr<Fp_T, Dim_V> initial_candidate() {
+      auto individual = _pool.acquire(_setup.get_genome_generator().initial_genome().size(), _objective_count);
+      individual->genome() = _setup.get_genome_generator().initial_genome();
+      if (!_zero_asked) {
+        _zero_asked = true;
+        _zero_candidate = individual.get();
+      } else {
         _setup.get_genome_generator()(individual);
-        contiguous_failures++;
-        switch (_state) {
-        [[unlikely]]
-        case state::STOPPING:
-        [[unlikely]]
-        case state::STOPPED:
+      }
+      return individual;
+    }
+
+    void display_final_message(exit_flag flag) {
+      _log.info() << "Optimization finished.";
+      _log.info() << "Total evaluations: " << _statistics.evaluation_count();
+      _log.info() << "Total elapsed time: " << elapsed_time_ms().count() << "ms";
+    }
+
+    /**
+     * @brief Evaluates the individual under the token, whose deadline starts with the evaluation. Returns NaN without
+     * evaluating once a budget is exhausted, and NaN if the token was cancelled (or timed out) during the evaluation.
+     * Individuals whose fitness is bound to exceed `threshold` are rejected without completing their evaluation.
+     */
+    Fp_T evaluate(base_individual<Fp_T, Dim_V> &individual, const cancellation_token &token,
+                  Fp_T threshold = std::numeric_limits<Fp_T>::infinity()) {
+      if (token.cancelled() || budget_exhausted()) {
+        return std::numeric_limits<Fp_T>::quiet_NaN();
+      }
+      token.arm(_setup.evaluation_time_limit());
+      MINIMACORE_TRACE_SCOPE("evaluate", "evaluation");
+      perf_phase_counters::scope counters = measure(profiling_phase::EVALUATION);
+      const auto begin = std::chrono::steady_clock::now();
+      individual.reset_samples();
+      _statistics.increment_evaluation_count(_setup.evaluate(individual, token, threshold));
+      _evaluation_time_ns.fetch_add((std::chrono::steady_clock::now() - begin).count(), std::memory_order_relaxed);
+      _timed_evaluations.fetch_add(1, std::memory_order_relaxed);
+      return token.cancelled() ? std::numeric_limits<Fp_T>::quiet_NaN() : individual.overall_fitness();
+    }
+
+    Fp_T evaluate(base_individual<Fp_T, Dim_V> &individual) {
+      return evaluate(individual, make_token());
+    }
+
+    Fp_T evaluate(const individual_ptr<Fp_T, Dim_V> &individual) {
+      return evaluate(*individual);
+    }
+
+    /**
+     * @brief Parts the nested reductions (see parallel_reduce) of each evaluation may split into when `batch`
+     * evaluations run at once. Parallelism stays at the individual level when the batch fills the executor or the
+     * evaluations are too cheap to split; otherwise the idle share of the executor goes to the data of each evaluation.
+     */
+    [[nodiscard]] size_t nested_width(size_t batch) const {
+      const size_t concurrency = _executor->concurrency();
+      const size_t evaluations = _timed_evaluations.load(std::memory_order_relaxed);
+      if (batch == 0 || batch >= concurrency || evaluations == 0) {
+        return 1;
+      }
+      const std::chrono::nanoseconds mean_time(_evaluation_time_ns.load(std::memory_order_relaxed) /
+                                               std::int64_t(evaluations));
+      return mean_time < nested_parallelism_threshold ? 1 : (concurrency + batch - 1) / batch;
+    }
+
+    /**
+     * @brief Token of one evaluation, stateless when neither a time limit nor a budget can cancel it.
+     */
+    [[nodiscard]] cancellation_token make_token() const {
+      return _cancellable ? cancellation_token::create() : cancellation_token{};
+    }
+
+    void collect_budgets() {
+      _budgets.clear();
+      for (const auto &condition : _setup.termination_conditions()) {
+        if (condition->is_budget()) {
+          _budgets.push_back(condition.get());
+        }
+      }
+      _cancellable =
+          !_budgets.empty() || _setup.evaluation_time_limit() > cancellation_token::clock_t::duration::zero();
+    }
+
+    /**
+     * @brief Whether a budget termination is met. Safe to call from the evaluation threads.
+     */
+    [[nodiscard]] bool budget_exhausted() const {
+      return std::ranges::any_of(_budgets, [this](const auto *budget) { return (*budget)(_statistics); });
+    }
+
+    /**
+     * @brief Waits for the i-th evaluation task. Without time limit or budget this is a plain wait; otherwise the wait
+     * gives up as soon as the evaluation exceeds its deadline or a budget is exhausted, cancels the evaluation and
+     * returns NaN, leaving the future pending.
+     */
+    Fp_T await_evaluation(size_t i) {
+      auto &future = _futures[i];
+      if (!_cancellable) {
+        return future.get();
+      }
+      const cancellation_token &token = _tokens[i];
+      while (future.wait_until(std::min(token.deadline(), cancellation_token::clock_t::now() + budget_poll_interval)) !=
+             std::future_status::ready) {
+        if (token.cancelled() || budget_exhausted()) {
+          token.cancel();
+          return std::numeric_limits<Fp_T>::quiet_NaN();
+        }
+      }
+      return future.get();
+    }
+
+    /**
+     * @brief Submits the evaluation of the individual as the next task awaited by await_evaluation.
+     */
+    void submit_evaluation(base_individual<Fp_T, Dim_V> &individual, size_t width) {
+      const auto &token = _tokens.emplace_back(make_token());
+      _futures.emplace_back(
+          _executor->submit([this, raw = &individual, token]() { return evaluate(*raw, token); }, width));
+    }
+
+    /**
+     * @brief Returns the abandoned individuals whose evaluation has since returned to the pool.
+     */
+    void reclaim_abandoned() {
+      std::erase_if(_abandoned, [this](auto &abandoned) {
+        if (abandoned.second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
           return false;
-        default:
-          break;
         }
+        _pool.release(std::move(abandoned.first));
+        return true;
+      });
+    }
+
+    /**
+     * @brief Evaluates individual zero on the runner thread, or, when a time limit or budget may cancel it, on the
+     * executor and on a copy, so that an evaluation given up on never writes to it later. Individual zero keeps NaN
+     * objectives if its evaluation fails.
+     */
+    void initialize_individual_zero() {
+      _log.info() << "Initializing individual zero";
+      _individual_zero = std::make_shared<base_individual<Fp_T, Dim_V>>(_setup.get_genome_generator().initial_genome(),
+                                                                        _objective_count);
+      _individual_zero->set_fidelity(_setup.fidelity_levels() - 1);
+      if (!_cancellable) {
+        evaluate(_individual_zero);
+        _log.info() << "Individual zero fitness: " << _individual_zero->overall_fitness();
+        return;
       }
-      if (contiguous_failures >= _setup.max_contiguous_failure_on_initialization()) {
-        _log << logger::wrapped_uts_timestamp()
-             << "Failed to initialize population. Maximum contiguous failure reached: "
-             << _setup.max_contiguous_failure_on_initialization() << '\n';
-        return false;
+      auto trial = std::make_shared<base_individual<Fp_T, Dim_V>>(*_individual_zero);
+      _futures.clear();
+      _tokens.clear();
+      submit_evaluation(*trial, nested_width(1));
+      if (std::isnan(await_evaluation(0)) && _futures[0].valid()) {
+        discard(std::move(trial), _futures[0]);
+      } else {
+        _individual_zero = std::move(trial);
       }
-      return true;
+      _log.info() << "Individual zero fitness: " << _individual_zero->overall_fitness();
     }
 
+    /**
+     * @brief Evaluates the initial population in rounds, each slot whose evaluation failed getting a new genome, up to
+     * max_contiguous_failure_on_initialization failures per slot. Once a budget is exhausted the slots left are dropped
+     * and the population is left short, the run then ends at the termination check.
+     * @return false if a slot reached the failure limit or the run was stopped
+     */
     bool initialize_population() {
-      _log << logger::wrapped_uts_timestamp() << "Initializing population, size = " << _setup.population_size() << '\n';
+      MINIMACORE_TRACE_SCOPE("initialize_population", "runner");
+      _log.info() << "Initializing population, size = " << _setup.population_size();
+      const auto &initial_genome = _setup.get_genome_generator().initial_genome();
       while (_population.size() < _setup.population_size()) {
-        _population.emplace_back(
-            std::make_shared<base_individual<Fp_T>>(_setup.get_genome_generator().initial_genome(), objective_count()));
+        auto &individual = _population.emplace_back(_pool.acquire(initial_genome.size(), _objective_count));
+        individual->genome() = initial_genome;
+        _setup.get_genome_generator()(individual);
       }
 
-      vector<std::future<bool>> futures;
-      futures.reserve(_population.size());
-      for (auto &individual : _population) {
-        futures.emplace_back(_threads.enqueue([this, &individual]() { return initialize_individual(individual); }));
+      vector<size_t> pending(_population.size());
+      std::iota(pending.begin(), pending.end(), 0);
+      vector<size_t> failures(_population.size(), 0);
+      while (!pending.empty() && !budget_exhausted()) {
+        if (_state == state::STOPPING || _state == state::STOPPED) [[unlikely]] {
+          return false;
+        }
+        _futures.clear();
+        _tokens.clear();
+        const size_t width = nested_width(pending.size());
+        for (size_t slot : pending) {
+          submit_evaluation(*_population[slot], width);
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < pending.size(); i++) {
+          const size_t slot = pending[i];
+          if (!std::isnan(await_evaluation(i))) {
+            continue;
+          }
+          if (_futures[i].valid()) {
+            // Given up on: the task still holds the individual
+            discard(std::move(_population[slot]), _futures[i]);
+            _population[slot] = _pool.acquire(initial_genome.size(), _objective_count);
+            _population[slot]->genome() = initial_genome;
+          }
+          pending[kept++] = slot;
+          if (budget_exhausted()) {
+            continue;
+          }
+          if (++failures[slot] >= _setup.max_contiguous_failure_on_initialization()) {
+            _log.warning() << "Failed to initialize population. Maximum contiguous failure reached: "
+                           << _setup.max_contiguous_failure_on_initialization();
+            return false;
+          }
+          _setup.get_genome_generator()(_population[slot]);
+        }
+        pending.resize(kept);
+      }
+      if (!pending.empty()) {
+        _log.info() << "Budget exhausted during initialization, " << pending.size() << " individuals left out";
+        for (size_t slot : pending) {
+          _pool.release(std::move(_population[slot]));
+        }
+        std::erase(_population, nullptr);
       }
 
-      bool success_flag = true;
-      std::ranges::for_each(futures, [this, &success_flag](auto &f) { success_flag &= f.get(); });
-      if (success_flag) {
-        update_best_individual();
+      if (auto *surrogate = _setup.surrogate()) {
+        for (const auto &individual : _population) {
+          surrogate->update(individual->genome(), individual->overall_fitness());
+        }
       }
-      return success_flag;
+      promote(_population);
+      update_best_individual();
+      return true;
     }
 
-    void fill_population(population_t<Fp_T> &reproduction_set) {
-      std::random_device device{};
-      std::mt19937_64 generator{static_cast<std::mt19937_64::result_type>(device())};
-      std::uniform_real_distribution<Fp_T> distribution(0., 1.);
-      while (_population.size() < _setup.population_size()) {
+    individual_ptr<Fp_T, Dim_V> breed(const population_t<Fp_T, Dim_V> &reproduction_set) {
+      perf_phase_counters::scope counters = measure(profiling_phase::VARIATION);
+      const auto &parent = random_pick(reproduction_set);
+      auto individual = _pool.acquire(parent->genome_size(), _objective_count);
+      if (_setup.should_mutate()) {
+        // Sparse mutations produce copy-on-write offspring, materialized only if an evaluation reads the dense genome
+        if (_setup.sample_mutation(*parent, _delta)) {
+          individual->derive(parent, _delta);
+        } else {
+          _setup.mutate(*parent, individual->genome());
+        }
+      } else {
+        _setup.cross(*parent, *random_pick(reproduction_set), individual->genome());
+      }
+      return individual;
+    }
+
+    /**
+     * @brief Breeds and evaluates offspring until the population is full. Once a budget is exhausted the population is
+     * left short, the run then ends at the termination check.
+     */
+    void fill_population(population_t<Fp_T, Dim_V> &reproduction_set) {
+      auto *surrogate = _setup.surrogate();
+      reclaim_abandoned();
+      while (_population.size() < _setup.population_size() && !budget_exhausted()) {
         const size_t count{_setup.population_size() - _population.size()};
-        vector<std::future<individual_ptr<Fp_T>>> futures;
-        futures.reserve(count);
+        _offspring.clear();
+        _futures.clear();
+        _tokens.clear();
+        _predictions.clear();
+        if (surrogate && surrogate->size() > 0 && _setup.surrogate_candidate_factor() > 1) {
+          breed_screened(reproduction_set, count, *surrogate);
+        } else {
+          for (size_t i = 0; i < count; i++) {
+            _offspring.emplace_back(breed(reproduction_set));
+          }
+        }
+        const size_t width = nested_width(count);
+        for (auto &individual : _offspring) {
+          const auto &token = _tokens.emplace_back(make_token());
+          _futures.emplace_back(
+              _executor->submit([this, raw = individual.get(), token,
+                                 threshold = _survival_threshold]() { return evaluate(*raw, token, threshold); },
+                                width));
+        }
+
+        size_t accepted = 0;
+        for (size_t i = 0; i < count; i++) {
+          // Individuals are discarded if the evaluation fails or times out
+          const Fp_T fitness = await_evaluation(i);
+          if (std::isnan(fitness)) {
+            discard(std::move(_offspring[i]), _futures[i]);
+            continue;
+          }
+          if (_offspring[i]->is_rejected()) {
+            // Bounded fitness, kept out of the surrogate
+            _pruned_evaluations++;
+          } else if (surrogate) {
+            if (i < _predictions.size() && !std::isnan(_predictions[i])) {
+              _surrogate_error += std::abs(_predictions[i] - fitness);
+              _surrogate_predictions++;
+            }
+            surrogate->update(_offspring[i]->genome(), fitness);
+          }
+          _offspring[accepted++] = std::move(_offspring[i]);
+        }
+        _offspring.resize(accepted);
+        promote(_offspring);
+        for (auto &individual : _offspring) {
+          _population.emplace_back(std::move(individual));
+        }
+      }
+      _offspring.clear();
+    }
+
+    /**
+     * @brief Successive halving: evaluates the best promotion fraction of the individuals, all at the lowest fidelity,
+     * again at the next fidelity level, then the best fraction of those at the level after, and so on. Individuals
+     * whose evaluation fails on promotion are removed from `individuals`.
+     */
+    void promote(population_t<Fp_T, Dim_V> &individuals) {
+      const size_t levels = _setup.fidelity_levels();
+      if (levels <= 1 || individuals.empty()) {
+        return;
+      }
+      MINIMACORE_TRACE_SCOPE("promote", "runner");
+      _promoted.assign(individuals.begin(), individuals.end());
+      for (size_t level = 1; level < levels && !_promoted.empty() && !budget_exhausted(); level++) {
+        const size_t count =
+            std::max<size_t>(1, size_t(std::ceil(_setup.promotion_fraction() * double(_promoted.size()))));
+        std::ranges::partial_sort(_promoted, _promoted.begin() + long(count), {},
+                                  [](const auto &individual) { return individual->overall_fitness(); });
+        _promoted.resize(count);
+        _futures.clear();
+        _tokens.clear();
+        const size_t width = nested_width(count);
+        for (auto &individual : _promoted) {
+          individual->set_fidelity(level);
+          const auto &token = _tokens.emplace_back(make_token());
+          _futures.emplace_back(
+              _executor->submit([this, raw = individual.get(), token]() { return evaluate(*raw, token); }, width));
+        }
+        size_t kept = 0;
         for (size_t i = 0; i < count; i++) {
-          Fp_T chance = distribution(generator);
-          individual_ptr<Fp_T> individual;
-          if (_setup.get_mutation().should_mutate()) {
-            individual = std::make_shared<base_individual<Fp_T>>(_setup.get_mutation()(*random_pick(reproduction_set)),
-                                                                 objective_count());
-          } else {
-            individual = std::make_shared<base_individual<Fp_T>>(
-                _setup.crossover()(*random_pick(reproduction_set), *random_pick(reproduction_set)), objective_count());
+          if (std::isnan(await_evaluation(i))) {
+            auto it = std::ranges::find(individuals, _promoted[i]);
+            _promoted[i].reset();
+            discard(std::move(*it), _futures[i]);
+            individuals.erase(it);
+            continue;
+          }
+          _promoted[kept++] = std::move(_promoted[i]);
+        }
+        _promoted.resize(kept);
+        _promotions += kept;
+      }
+      _promoted.clear();
+    }
+
+    /**
+     * @brief Registers the statistics of the population, leaving out the rejected offspring whose fitness is a bound.
+     */
+    void register_statistic() {
+      if (std::ranges::none_of(_population, [](const auto &individual) { return individual->is_rejected(); })) {
+        _statistics.register_statistic(_population);
+        return;
+      }
+      std::ranges::copy_if(_population, std::back_inserter(_scored),
+                           [](const auto &individual) { return !individual->is_rejected(); });
+      _statistics.register_statistic(_scored);
+      // Not kept, the pool only recycles individuals referenced nowhere else
+      _scored.clear();
+    }
+
+    /**
+     * @brief Evaluates the population again once the evaluations changed their scoring (see
+     * base_evaluation::begin_generation), so the survivors compete with the offspring on the same terms. Published
+     * individuals are not modified: each is rescored on a copy swapped into the population. Individuals whose new
+     * evaluation fails keep their previous fitness.
+     */
+    void rescore_population() {
+      if (_population.empty()) {
+        return;
+      }
+      MINIMACORE_TRACE_SCOPE("rescore_population", "runner");
+      reclaim_abandoned();
+      _offspring.clear();
+      _futures.clear();
+      _tokens.clear();
+      const size_t width = nested_width(_population.size());
+      for (const auto &individual : _population) {
+        auto &copy = _offspring.emplace_back(_pool.acquire(individual->genome_size(), _objective_count));
+        *copy = *individual;
+        const auto &token = _tokens.emplace_back(make_token());
+        _futures.emplace_back(
+            _executor->submit([this, raw = copy.get(), token]() { return evaluate(*raw, token); }, width));
+      }
+      for (size_t i = 0; i < _population.size(); i++) {
+        if (std::isnan(await_evaluation(i))) {
+          discard(std::move(_offspring[i]), _futures[i]);
+          continue;
+        }
+        _pool.release(std::exchange(_population[i], std::move(_offspring[i])));
+      }
+      _offspring.clear();
+    }
+
+    /**
+     * @brief Drops an individual whose evaluation failed or timed out. An individual still being evaluated is set aside
+     * until its task, which references it, returns.
+     */
+    void discard(individual_ptr<Fp_T, Dim_V> &&individual, std::future<Fp_T> &future) {
+      if (future.valid()) {
+        _abandoned.emplace_back(std::move(individual), std::move(future));
+        _abandoned_evaluations++;
+      } else {
+        _pool.release(std::move(individual));
+      }
+    }
+
+    /**
+     * @brief Breeds `candidate_factor` times `count` candidates into the offspring and keeps the `count` ones with the
+     * best predicted fitness, in order, with their predictions. The others go back to the pool unevaluated.
+     */
+    void breed_screened(const population_t<Fp_T, Dim_V> &reproduction_set, size_t count,
+                        const base_surrogate<Fp_T, Dim_V> &surrogate) {
+      const size_t candidates = count * _setup.surrogate_candidate_factor();
+      _candidates.clear();
+      _candidate_predictions.clear();
+      for (size_t i = 0; i < candidates; i++) {
+        const auto &candidate = _candidates.emplace_back(breed(reproduction_set));
+        const Fp_T prediction = surrogate.predict(candidate->genome());
+        _candidate_predictions.push_back(std::isnan(prediction) ? std::numeric_limits<Fp_T>::infinity() : prediction);
+      }
+      _candidate_order.resize(candidates);
+      std::iota(_candidate_order.begin(), _candidate_order.end(), 0);
+      std::ranges::partial_sort(_candidate_order, _candidate_order.begin() + long(count), [this](size_t a, size_t b) {
+        return _candidate_predictions[a] < _candidate_predictions[b];
+      });
+      for (size_t i = 0; i < candidates; i++) {
+        const size_t candidate = _candidate_order[i];
+        if (i < count) {
+          _offspring.emplace_back(std::move(_candidates[candidate]));
+          _predictions.push_back(_candidate_predictions[candidate]);
+        } else {
+          _pool.release(std::move(_candidates[candidate]));
+        }
+      }
+      _candidates.clear();
+    }
+
+    /**
+     * @brief Records the mean absolute error of the surrogate predictions of the generation as the `surrogate_error`
+     * metric of the statistics.
+     */
+    void record_surrogate_error() {
+      if (_surrogate_predictions > 0) {
+        _statistics.record_metric("surrogate_error", double(_surrogate_error / Fp_T(_surrogate_predictions)));
+      }
+      _surrogate_error = 0;
+      _surrogate_predictions = 0;
+    }
+
+    /**
+     * @brief Records the number of evaluations of the generation given up on (timed out or cut by a budget) as the
+     * `abandoned_evaluations` metric of the statistics, when evaluations can be cancelled.
+     */
+    void record_abandoned_evaluations() {
+      if (_cancellable) {
+        _statistics.record_metric("abandoned_evaluations", double(_abandoned_evaluations));
+      }
+      _abandoned_evaluations = 0;
+    }
+
+    /**
+     * @brief Worst overall fitness among the survivors of the replacement: with a replacement keeping the best, an
+     * offspring beyond it is dropped by the next replacement. Infinite, so that nothing is pruned, unless evaluation
+     * pruning is enabled with such a replacement.
+     */
+    Fp_T survival_threshold() const {
+      if (!_setup.evaluation_pruning() || !_setup.replacement_keeps_best() || _population.empty()) {
+        return std::numeric_limits<Fp_T>::infinity();
+      }
+      return std::ranges::max(_population, {}, [](const auto &individual) { return individual->overall_fitness(); })
+          ->overall_fitness();
+    }
+
+    /**
+     * @brief Offspring rejected by evaluation pruning during the generation, as the `pruned_evaluations` metric of the
+     * statistics, when pruning is enabled.
+     */
+    void record_pruned_evaluations() {
+      if (_setup.evaluation_pruning()) {
+        _statistics.record_metric("pruned_evaluations", double(_pruned_evaluations));
+      }
+      _pruned_evaluations = 0;
+    }
+
+    /**
+     * @brief Promotions to a higher fidelity during the generation, as the `promotions` metric of the statistics, with
+     * successive halving.
+     */
+    void record_promotions() {
+      if (_setup.fidelity_levels() > 1) {
+        _statistics.record_metric("promotions", double(_promotions));
+      }
+      _promotions = 0;
+    }
+
+    /**
+     * @brief Racing on the boundary of the next replacement, for noisy evaluations. Individuals whose mean fitness is
+     * within the racing confidence (in standard errors) of the boundary between its survivors and the others, and the
+     * survivors evaluated only once, are evaluated again as one batch. Rounds repeat until every rank relative to the
+     * boundary is settled or the individuals left reach the sample limit. Published individuals are not modified: each
+     * sample is evaluated on a copy, which takes the place of the individual in the population once the sample is
+     * folded into its mean.
+     */
+    void race() {
+      const size_t max_samples = _setup.racing_samples();
+      const size_t survivors = _survivor_count;
+      if (max_samples <= 1 || !_setup.replacement_keeps_best() || survivors == 0 || survivors >= _population.size()) {
+        return;
+      }
+      MINIMACORE_TRACE_SCOPE("race", "runner");
+      const auto confidence = Fp_T(_setup.racing_confidence());
+      reclaim_abandoned();
+      for (size_t round = 1; round < max_samples && !budget_exhausted(); round++) {
+        _ranked.assign(_population.begin(), _population.end());
+        std::ranges::sort(_ranked, {}, [](const auto &individual) { return individual->overall_fitness(); });
+        const Fp_T boundary = (_ranked[survivors - 1]->overall_fitness() + _ranked[survivors]->overall_fitness()) / 2;
+        _racing.clear();
+        for (size_t i = 0; i < _ranked.size(); i++) {
+          const auto &individual = _ranked[i];
+          if (individual->samples() >= max_samples) {
+            continue;
+          }
+          if (individual->samples() < 2
+                  ? i < survivors
+                  : std::abs(individual->overall_fitness() - boundary) <
+                        confidence * std::sqrt(individual->fitness_variance() / Fp_T(individual->samples()))) {
+            _racing.push_back(individual);
+          }
+        }
+        // Replaced racing individuals are then only referenced by the population, and go back to the pool
+        _ranked.clear();
+        if (_racing.empty()) {
+          break;
+        }
+        _offspring.clear();
+        _futures.clear();
+        _tokens.clear();
+        const size_t width = nested_width(_racing.size());
+        for (const auto &individual : _racing) {
+          auto &trial = _offspring.emplace_back(_pool.acquire(individual->genome_size(), _objective_count));
+          *trial = *individual;
+          const auto &token = _tokens.emplace_back(make_token());
+          _futures.emplace_back(
+              _executor->submit([this, raw = trial.get(), token]() { return evaluate(*raw, token); }, width));
+        }
+        for (size_t i = 0; i < _racing.size(); i++) {
+          if (std::isnan(await_evaluation(i))) {
+            discard(std::move(_offspring[i]), _futures[i]);
+            continue;
           }
+          auto &trial = _offspring[i];
+          _sample = trial->get_object_fitnesses();
+          *trial = *_racing[i];
+          trial->add_sample(_sample);
+          auto &slot = *std::ranges::find(_population, _racing[i]);
+          _racing[i].reset();
+          _pool.release(std::exchange(slot, std::move(trial)));
+          _racing_evaluations++;
+        }
+        _offspring.clear();
+      }
+      _racing.clear();
+    }
 
-          futures.emplace_back(_threads.enqueue([this, individual]() {
-            // Individuals are discarded if the evaluation fails
-            return std::isnan(evaluate(individual)) ? individual_ptr<Fp_T>(nullptr) : individual;
-          }));
+    /**
+     * @brief Evaluations spent by racing during the generation, as the `racing_evaluations` metric of the statistics,
+     * when racing is enabled.
+     */
+    void record_racing_evaluations() {
+      if (_setup.racing_samples() > 1) {
+        _statistics.record_metric("racing_evaluations", double(_racing_evaluations));
+      }
+      _racing_evaluations = 0;
+    }
+
+    /**
+     * @brief Memetic step: runs the configured local search on the best individuals in parallel. Evaluations spent by
+     * the local search are counted like any other evaluation.
+     */
+    void refine_elites() {
+      const auto *local_search = _setup.local_search();
+      if (!local_search || _statistics.current_generation() % _setup.local_search_interval() != 0) {
+        return;
+      }
+      MINIMACORE_TRACE_SCOPE("refine_elites", "runner");
+      const size_t elites = std::min(_setup.local_search_elites(), _population.size());
+      if (elites == 0) {
+        return;
+      }
+      std::ranges::nth_element(_population, _population.begin() + long(elites - 1),
+                               [](const auto &a, const auto &b) { return *a < *b; });
+      _offspring.clear();
+      _futures.clear();
+      _tokens.clear();
+      const size_t width = nested_width(elites);
+      for (size_t i = 0; i < elites; i++) {
+        // Elites are refined on a copy: the original may be the root of copy-on-write offspring, and is put back if
+        // the refinement is given up on
+        auto &elite = _population[i];
+        _offspring.push_back(elite);
+        elite = std::make_shared<base_individual<Fp_T, Dim_V>>(*elite);
+        // The evaluations of one refinement share its token, armed again by each of them
+        const auto &token = _tokens.emplace_back(make_token());
+        _futures.emplace_back(_executor->submit(
+            [this, local_search, individual = elite, token]() {
+              const size_t evaluations = (*local_search)(
+                  *individual, [this, &token](base_individual<Fp_T, Dim_V> &trial) { return evaluate(trial, token); });
+              _local_search_evaluations.fetch_add(evaluations, std::memory_order_relaxed);
+              return individual->overall_fitness();
+            },
+            width));
+      }
+      for (size_t i = 0; i < elites; i++) {
+        if (std::isnan(await_evaluation(i)) && _futures[i].valid()) {
+          discard(std::move(_population[i]), _futures[i]);
+          _population[i] = std::move(_offspring[i]);
         }
+      }
+      _offspring.clear();
+      _log.info() << "Local search refined " << elites << " elites using "
+                  << _local_search_evaluations.exchange(0, std::memory_order_relaxed) << " evaluations";
+    }
+
+    void open_counters() {
+      _profiling = _setup.hardware_counters() && _counters.open();
+      if (_setup.hardware_counters() && !_profiling) {
+        _log.warning() << "Hardware counters unavailable, the phases are not profiled";
+      }
+    }
 
-        for (auto &fut : futures) {
-          if (auto individual = fut.get()) {
-            _population.emplace_back(individual);
+    perf_phase_counters::scope measure(profiling_phase phase) {
+      return {_profiling ? &_counters : nullptr, size_t(phase)};
+    }
+
+    /**
+     * @brief Moves the counter totals of every phase into the statistics of the last registered generation.
+     */
+    void record_counters() {
+      if (!_profiling) {
+        return;
+      }
+      for (size_t phase = 0; phase < profiling_phase_names.size(); phase++) {
+        const perf_sample totals = _counters.take(phase);
+        for (size_t event = 0; event < perf_event_count; event++) {
+          if (_counters.available(perf_event(event))) {
+            _statistics.record_metric(string(profiling_phase_names[phase]) + '_' +
+                                          perf_counter_group::name(perf_event(event)),
+                                      totals.values[event]);
           }
         }
       }
     }
 
     void update_best_individual() {
+      if (_population.empty()) {
+        return;
+      }
       _best_individual =
           std::ranges::min(_population, [](auto &a, auto &b) { return a->overall_fitness() < b->overall_fitness(); });
     }
 
-    population_t<Fp_T> _population;
-    individual_ptr<Fp_T> _best_individual{nullptr};
-    individual_ptr<Fp_T> _individual_zero{nullptr};
+    population_t<Fp_T, Dim_V> _population;
+    population_t<Fp_T, Dim_V> _previous_generation;
+    population_t<Fp_T, Dim_V> _offspring;
+    population_t<Fp_T, Dim_V> _candidates;
+    vector<Fp_T> _predictions;
+    vector<Fp_T> _candidate_predictions;
+    vector<size_t> _candidate_order;
+    Fp_T _surrogate_error{0};
+    size_t _surrogate_predictions{0};
+    vector<std::future<Fp_T>> _futures;
+    vector<cancellation_token> _tokens;
+    // Offspring given up on while their evaluation was still running, returned to the pool once it returns
+    vector<std::pair<individual_ptr<Fp_T, Dim_V>, std::future<Fp_T>>> _abandoned;
+    vector<const termination_condition_base<Fp_T> *> _budgets;
+    bool _cancellable{false};
+    size_t _abandoned_evaluations{0};
+    Fp_T _survival_threshold{std::numeric_limits<Fp_T>::infinity()};
+    size_t _pruned_evaluations{0};
+    std::atomic_size_t _local_search_evaluations{0};
+    population_t<Fp_T, Dim_V> _scored;
+    population_t<Fp_T, Dim_V> _promoted;
+    size_t _promotions{0};
+    size_t _survivor_count{0};
+    population_t<Fp_T, Dim_V> _ranked;
+    population_t<Fp_T, Dim_V> _racing;
+    Eigen::VectorX<Fp_T> _sample;
+    size_t _racing_evaluations{0};
+    reproduction_selection_t<Fp_T, Dim_V> _reproduction_set;
+    // Stepped runs, driven by ask and tell
+    bool _stepping{false};
+    bool _initialized{false};
+    bool _generation_open{false};
+    bool _zero_asked{false};
+    const base_individual<Fp_T, Dim_V> *_zero_candidate{nullptr};
+    size_t _outstanding{0};
+    size_t _contiguous_failures{0};
+    genome_delta<Fp_T> _delta;
+    individual_pool<Fp_T, Dim_V> _pool;
+    size_t _objective_count{0};
+    individual_ptr<Fp_T, Dim_V> _best_individual{nullptr};
+    individual_ptr<Fp_T, Dim_V> _individual_zero{nullptr};
     evolution_statistics<Fp_T> _statistics;
-    setup<Fp_T> _setup;
+    Setup_T _setup;
     logger _log;
-    thread_pool _threads;
+    std::atomic<std::int64_t> _evaluation_time_ns{0};
+    std::atomic_size_t _timed_evaluations{0};
     std::atomic<state> _state = state::WAITING;
     time_point_t _start_time;
+    perf_phase_counters _counters{profiling_phase_names.size()};
+    bool _profiling{false};
+    // Destroyed first: abandoned evaluations may still be running and use the members above
+    unique_ptr<thread_pool> _owned_threads;
+    unique_ptr<base_executor> _owned_executor;
+    base_executor *_executor;
   };
 
+  template <typename Setup_T> runner(Setup_T) -> runner<typename Setup_T::value_type, Setup_T::dimension, Setup_T>;
+
 } // namespace minimacore::genetic_algorithm
 #endif // MINIMACORE_RUNNER_H
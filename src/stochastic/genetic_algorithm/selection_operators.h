@@ -5,8 +5,11 @@
 #include "base_individual.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <random>
-#include <set>
+#include <span>
 
 #ifdef __has_include
 #if __has_include(<execution>)
@@ -19,19 +22,20 @@
 
 namespace minimacore::genetic_algorithm {
 
-  template <floating_point_type Fp_T> population_t<Fp_T> &sort(population_t<Fp_T> &population) {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  population_t<Fp_T, Dim_V> &sort(population_t<Fp_T, Dim_V> &population) {
     std::sort(
 #ifdef HAS_EXECUTION_POLICIES
         std::execution::par_unseq,
 #endif
         population.begin(), population.end(),
-        [](const individual_ptr<Fp_T> &a, const individual_ptr<Fp_T> &b) { return *a < *b; });
+        [](const individual_ptr<Fp_T, Dim_V> &a, const individual_ptr<Fp_T, Dim_V> &b) { return *a < *b; });
     return population;
   }
 
-  template <floating_point_type Fp_T> class base_selection_for_reproduction {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class base_selection_for_reproduction {
   public:
-    virtual reproduction_selection_t<Fp_T> operator()(population_t<Fp_T> &population) const = 0;
+    virtual reproduction_selection_t<Fp_T, Dim_V> operator()(population_t<Fp_T, Dim_V> &population) const = 0;
     base_selection_for_reproduction() = default;
     base_selection_for_reproduction(const base_selection_for_reproduction &) = delete;
     base_selection_for_reproduction(base_selection_for_reproduction &&) = delete;
@@ -40,13 +44,13 @@ namespace minimacore::genetic_algorithm {
     virtual ~base_selection_for_reproduction() = default;
   };
 
-  template <floating_point_type Fp_T>
-  class truncation_selection_for_reproduction : public base_selection_for_reproduction<Fp_T> {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class truncation_selection_for_reproduction : public base_selection_for_reproduction<Fp_T, Dim_V> {
     size_t _selection_size = 0;
 
   public:
-    reproduction_selection_t<Fp_T> operator()(population_t<Fp_T> &population) const override {
-      reproduction_selection_t<Fp_T> result;
+    reproduction_selection_t<Fp_T, Dim_V> operator()(population_t<Fp_T, Dim_V> &population) const override {
+      reproduction_selection_t<Fp_T, Dim_V> result;
       result.reserve(_selection_size);
       sort(population);
       for (size_t selected = 0; selected < _selection_size; selected++) {
@@ -58,48 +62,248 @@ namespace minimacore::genetic_algorithm {
     explicit truncation_selection_for_reproduction(size_t selection_size) : _selection_size(selection_size) {}
   };
 
-  template <floating_point_type Fp_T>
-  class tournament_selection_for_reproduction : public base_selection_for_reproduction<Fp_T> {
+  /**
+   * @brief Tournament selection without replacement. Contestants are drawn by a partial Fisher-Yates shuffle over the
+   * indices of the individuals that have not won yet, and every winner is swap-removed from that pool, so a tournament
+   * costs O(tournament size) and an individual can never be selected twice.
+   *
+   * With more than one shard the shuffled pool is split into disjoint shards whose tournaments run in parallel, each
+   * shard filling its share of the selection.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class tournament_selection_for_reproduction : public base_selection_for_reproduction<Fp_T, Dim_V> {
   public:
-    reproduction_selection_t<Fp_T> operator()(population_t<Fp_T> &population) const override {
-      std::uniform_int_distribution<size_t> dist(0, population.size() - 1);
-      reproduction_selection_t<Fp_T> result;
-      result.reserve(_selection_size);
-      const size_t tournament_size = _tournament_size < population.size() ? _tournament_size : population.size();
-      const size_t selection_size = _selection_size < population.size() ? _selection_size : population.size();
-      std::set<individual_ptr<Fp_T>> selected_individuals;
+    reproduction_selection_t<Fp_T, Dim_V> operator()(population_t<Fp_T, Dim_V> &population) const override {
+      const size_t selection_size = std::min(_selection_size, population.size());
+      reproduction_selection_t<Fp_T, Dim_V> result(selection_size);
+      if (selection_size == 0) {
+        return result;
+      }
+      vector<size_t> candidates(population.size());
+      std::iota(candidates.begin(), candidates.end(), 0);
       std::random_device rd;
       std::mt19937_64 gen(static_cast<std::mt19937_64::result_type>(rd()));
-      while (selection_size > result.size()) {
-        reproduction_selection_t<Fp_T> tournament_selection;
-        while (tournament_selection.size() < tournament_size) {
-          auto &selected_for_tournament = population[dist(gen)];
-          if (std::find(tournament_selection.begin(), tournament_selection.end(), selected_for_tournament) ==
-              tournament_selection.end()) {
-            tournament_selection.push_back(selected_for_tournament);
+      const size_t shards = std::clamp<size_t>(_shards, 1, selection_size);
+      if (shards == 1) {
+        run_tournaments(population, candidates, result, gen);
+        return result;
+      }
+
+      std::ranges::shuffle(candidates, gen);
+      vector<std::mt19937_64::result_type> seeds(shards);
+      std::ranges::generate(seeds, gen);
+      vector<size_t> shard_indices(shards);
+      std::iota(shard_indices.begin(), shard_indices.end(), 0);
+      std::for_each(
+#ifdef HAS_EXECUTION_POLICIES
+          std::execution::par,
+#endif
+          shard_indices.begin(), shard_indices.end(), [&](size_t shard) {
+            const size_t first_candidate = shard * candidates.size() / shards;
+            const size_t last_candidate = (shard + 1) * candidates.size() / shards;
+            const size_t first_winner = shard * selection_size / shards;
+            const size_t last_winner = (shard + 1) * selection_size / shards;
+            std::mt19937_64 shard_gen(seeds[shard]);
+            run_tournaments(population,
+                            std::span(candidates).subspan(first_candidate, last_candidate - first_candidate),
+                            std::span(result).subspan(first_winner, last_winner - first_winner), shard_gen);
+          });
+      // A shard smaller than its share leaves empty slots
+      std::erase(result, nullptr);
+      return result;
+    }
+
+    explicit tournament_selection_for_reproduction(size_t tournament_size, size_t selection_size, size_t shards = 1)
+        : _tournament_size(tournament_size), _selection_size(selection_size), _shards(shards) {}
+
+  private:
+    void run_tournaments(const population_t<Fp_T, Dim_V> &population, std::span<size_t> candidates,
+                         std::span<individual_ptr<Fp_T, Dim_V>> winners, std::mt19937_64 &gen) const {
+      size_t available = candidates.size();
+      for (auto &winner : winners) {
+        if (available == 0) {
+          return;
+        }
+        const size_t contestants = std::clamp<size_t>(_tournament_size, 1, available);
+        size_t best = 0;
+        for (size_t i = 0; i < contestants; i++) {
+          std::uniform_int_distribution<size_t> dist(i, available - 1);
+          std::swap(candidates[i], candidates[dist(gen)]);
+          if (*population[candidates[i]] < *population[candidates[best]]) {
+            best = i;
           }
         }
+        winner = population[candidates[best]];
+        std::swap(candidates[best], candidates[--available]);
+      }
+    }
 
-        auto winner =
-            std::min_element(tournament_selection.begin(), tournament_selection.end(),
-                             [](const individual_ptr<Fp_T> &a, const individual_ptr<Fp_T> &b) { return *a < *b; });
+    size_t _tournament_size{0};
+    size_t _selection_size{0};
+    size_t _shards{1};
+  };
 
-        if (auto pair = selected_individuals.insert(*winner); pair.second) {
-          result.push_back(*pair.first);
+  /**
+   * @brief Shared part of the fitness-proportionate selectors. Fitness is minimized, so every individual is weighted by
+   * its distance to the worst fitness of the population, normalized to [0, 1] and raised to the selection pressure: a
+   * pressure of 0 selects uniformly, larger values favour the best individuals. Failed (NaN) individuals get no weight.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class fitness_proportionate_selection {
+  protected:
+    vector<Fp_T> weights(const population_t<Fp_T, Dim_V> &population) const {
+      vector<Fp_T> result(population.size());
+      std::transform(
+#ifdef HAS_EXECUTION_POLICIES
+          std::execution::par_unseq,
+#endif
+          population.begin(), population.end(), result.begin(),
+          [](const individual_ptr<Fp_T, Dim_V> &individual) { return individual->overall_fitness(); });
+      Fp_T best = std::numeric_limits<Fp_T>::infinity();
+      Fp_T worst = -std::numeric_limits<Fp_T>::infinity();
+      for (const Fp_T fitness : result) {
+        if (!std::isnan(fitness)) {
+          best = std::min(best, fitness);
+          worst = std::max(worst, fitness);
         }
       }
+      const Fp_T range = worst - best;
+      const Fp_T pressure = _pressure;
+      std::transform(
+#ifdef HAS_EXECUTION_POLICIES
+          std::execution::par_unseq,
+#endif
+          result.begin(), result.end(), result.begin(), [worst, range, pressure](Fp_T fitness) {
+            if (std::isnan(fitness)) {
+              return Fp_T(0);
+            }
+            // Equal fitnesses (or an infinite range) degrade to uniform selection
+            return range > 0 && std::isfinite(range) ? std::pow((worst - fitness) / range, pressure) + _floor : Fp_T(1);
+          });
       return result;
     }
 
-    explicit tournament_selection_for_reproduction(size_t tournament_size, size_t selection_size)
-        : _tournament_size(tournament_size), _selection_size(selection_size) {}
+    explicit fitness_proportionate_selection(size_t selection_size, Fp_T pressure)
+        : _selection_size(selection_size), _pressure(pressure) {}
 
-  private:
-    size_t _tournament_size{0};
     size_t _selection_size{0};
+    Fp_T _pressure{1};
+
+  private:
+    // Keeps the worst individual selectable
+    static constexpr Fp_T _floor = 1E-6;
+  };
+
+  /**
+   * @brief Roulette wheel selection with replacement. The wheel is stored as a Walker/Vose alias table, built in O(N),
+   * after which every spin costs O(1).
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class roulette_wheel_selection_for_reproduction : public base_selection_for_reproduction<Fp_T, Dim_V>,
+                                                    public fitness_proportionate_selection<Fp_T, Dim_V> {
+    using base = fitness_proportionate_selection<Fp_T, Dim_V>;
+
+  public:
+    reproduction_selection_t<Fp_T, Dim_V> operator()(population_t<Fp_T, Dim_V> &population) const override {
+      reproduction_selection_t<Fp_T, Dim_V> result;
+      if (population.empty()) {
+        return result;
+      }
+      vector<Fp_T> probability = this->weights(population);
+      const size_t n = probability.size();
+      const Fp_T total = std::reduce(
+#ifdef HAS_EXECUTION_POLICIES
+          std::execution::par_unseq,
+#endif
+          probability.begin(), probability.end(), Fp_T(0));
+      if (!(total > 0)) {
+        return result;
+      }
+      const Fp_T scale = Fp_T(n) / total;
+      std::ranges::for_each(probability, [scale](Fp_T &p) { p *= scale; });
+
+      // Vose's construction: pair every under-full column with an over-full one
+      vector<size_t> alias(n);
+      std::iota(alias.begin(), alias.end(), 0);
+      vector<size_t> small;
+      vector<size_t> large;
+      for (size_t i = 0; i < n; i++) {
+        (probability[i] < 1 ? small : large).push_back(i);
+      }
+      while (!small.empty() && !large.empty()) {
+        const size_t less = small.back();
+        const size_t more = large.back();
+        small.pop_back();
+        alias[less] = more;
+        probability[more] -= 1 - probability[less];
+        if (probability[more] < 1) {
+          large.pop_back();
+          small.push_back(more);
+        }
+      }
+      // Leftovers are full columns up to rounding errors
+      std::ranges::for_each(small, [&probability](size_t i) { probability[i] = 1; });
+      std::ranges::for_each(large, [&probability](size_t i) { probability[i] = 1; });
+
+      std::random_device rd;
+      std::mt19937_64 gen(static_cast<std::mt19937_64::result_type>(rd()));
+      std::uniform_int_distribution<size_t> column(0, n - 1);
+      std::uniform_real_distribution<Fp_T> coin(0, 1);
+      result.reserve(this->_selection_size);
+      for (size_t i = 0; i < this->_selection_size; i++) {
+        const size_t c = column(gen);
+        result.push_back(population[coin(gen) < probability[c] ? c : alias[c]]);
+      }
+      return result;
+    }
+
+    explicit roulette_wheel_selection_for_reproduction(size_t selection_size, Fp_T pressure = 1)
+        : base(selection_size, pressure) {}
   };
 
-  template <floating_point_type Fp_T> using ranked_selection_t = vector<population_t<Fp_T>>;
+  /**
+   * @brief Stochastic universal sampling: a single spin of a wheel with equally spaced pointers. The wheel is the
+   * inclusive prefix sum of the weights (a parallel scan), which is swept once, so the selection costs O(N + selection
+   * size) and its spread around the expected counts is minimal.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class stochastic_universal_sampling_for_reproduction : public base_selection_for_reproduction<Fp_T, Dim_V>,
+                                                         public fitness_proportionate_selection<Fp_T, Dim_V> {
+    using base = fitness_proportionate_selection<Fp_T, Dim_V>;
+
+  public:
+    reproduction_selection_t<Fp_T, Dim_V> operator()(population_t<Fp_T, Dim_V> &population) const override {
+      reproduction_selection_t<Fp_T, Dim_V> result;
+      vector<Fp_T> wheel = this->weights(population);
+      std::inclusive_scan(
+#ifdef HAS_EXECUTION_POLICIES
+          std::execution::par_unseq,
+#endif
+          wheel.begin(), wheel.end(), wheel.begin());
+      if (wheel.empty() || !(wheel.back() > 0) || this->_selection_size == 0) {
+        return result;
+      }
+      const Fp_T spacing = wheel.back() / Fp_T(this->_selection_size);
+      std::random_device rd;
+      std::mt19937_64 gen(static_cast<std::mt19937_64::result_type>(rd()));
+      const Fp_T start = std::uniform_real_distribution<Fp_T>(0, spacing)(gen);
+      result.reserve(this->_selection_size);
+      size_t index = 0;
+      for (size_t i = 0; i < this->_selection_size; i++) {
+        const Fp_T pointer = start + Fp_T(i) * spacing;
+        while (index + 1 < wheel.size() && wheel[index] <= pointer) {
+          index++;
+        }
+        result.push_back(population[index]);
+      }
+      return result;
+    }
+
+    explicit stochastic_universal_sampling_for_reproduction(size_t selection_size, Fp_T pressure = 1)
+        : base(selection_size, pressure) {}
+  };
+
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using ranked_selection_t = vector<population_t<Fp_T, Dim_V>>;
 
   class ranked_selection {
   public:
@@ -108,8 +312,9 @@ namespace minimacore::genetic_algorithm {
       INDIVIDUALS,
     };
 
-    template <floating_point_type Fp_T>
-    static bool is_dominant(const individual_ptr<Fp_T> &individual, const reproduction_selection_t<Fp_T> &subgroup) {
+    template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+    static bool is_dominant(const individual_ptr<Fp_T, Dim_V> &individual,
+                            const reproduction_selection_t<Fp_T, Dim_V> &subgroup) {
       return std::all_of(
 #ifdef HAS_EXECUTION_POLICIES
           std::execution::par_unseq,
@@ -126,10 +331,10 @@ namespace minimacore::genetic_algorithm {
           });
     }
 
-    template <floating_point_type Fp_T>
-    static ranked_selection_t<Fp_T> rank_population(const population_t<Fp_T> &population) {
-      ranked_selection_t<Fp_T> ranks;
-      population_t<Fp_T> cpy(population);
+    template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+    static ranked_selection_t<Fp_T, Dim_V> rank_population(const population_t<Fp_T, Dim_V> &population) {
+      ranked_selection_t<Fp_T, Dim_V> ranks;
+      population_t<Fp_T, Dim_V> cpy(population);
       while (!cpy.empty()) {
         auto &current_rank = ranks.emplace_back();
         for (auto &individual : cpy) {
@@ -152,12 +357,13 @@ namespace minimacore::genetic_algorithm {
     select_by _select_by{0};
   };
 
-  template <floating_point_type Fp_T>
-  class ranked_selection_for_reproduction : public base_selection_for_reproduction<Fp_T>, public ranked_selection {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class ranked_selection_for_reproduction : public base_selection_for_reproduction<Fp_T, Dim_V>,
+                                            public ranked_selection {
   public:
-    reproduction_selection_t<Fp_T> operator()(population_t<Fp_T> &population) const override {
+    reproduction_selection_t<Fp_T, Dim_V> operator()(population_t<Fp_T, Dim_V> &population) const override {
       auto ranks = rank_population(population);
-      reproduction_selection_t<Fp_T> result;
+      reproduction_selection_t<Fp_T, Dim_V> result;
       switch (_select_by) {
       case select_by::RANKS: {
         size_t selected_amount{0};
@@ -177,7 +383,7 @@ namespace minimacore::genetic_algorithm {
       size_t selected_amount{0};
       int count{0};
       while (selected_amount < _selection_size) {
-        reproduction_selection_t<Fp_T> subgroup;
+        reproduction_selection_t<Fp_T, Dim_V> subgroup;
         std::for_each(
 #ifdef HAS_EXECUTION_POLICIES
             std::execution::par_unseq,
@@ -207,12 +413,21 @@ namespace minimacore::genetic_algorithm {
     }
 
     ranked_selection_for_reproduction(size_t selection_size, select_by by)
-        : base_selection_for_reproduction<Fp_T>(), ranked_selection(selection_size, by) {}
+        : base_selection_for_reproduction<Fp_T, Dim_V>(), ranked_selection(selection_size, by) {}
   };
 
-  template <floating_point_type Fp_T> class base_selection_for_replacement {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class base_selection_for_replacement {
   public:
-    virtual population_t<Fp_T> &operator()(population_t<Fp_T> &population) const = 0;
+    virtual population_t<Fp_T, Dim_V> &operator()(population_t<Fp_T, Dim_V> &population) const = 0;
+
+    /**
+     * @brief True if the operator keeps the best individuals by overall fitness, in which case an offspring worse than
+     * every survivor cannot survive the next replacement. Evaluation pruning relies on it.
+     */
+    [[nodiscard]] virtual bool keeps_best() const {
+      return false;
+    }
+
     base_selection_for_replacement() = default;
     base_selection_for_replacement(const base_selection_for_replacement &) = delete;
     base_selection_for_replacement(base_selection_for_replacement &&) = delete;
@@ -221,10 +436,10 @@ namespace minimacore::genetic_algorithm {
     virtual ~base_selection_for_replacement() = default;
   };
 
-  template <floating_point_type Fp_T>
-  class generational_selection_for_replacement : public base_selection_for_replacement<Fp_T> {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class generational_selection_for_replacement : public base_selection_for_replacement<Fp_T, Dim_V> {
   public:
-    population_t<Fp_T> &operator()(population_t<Fp_T> &population) const override {
+    population_t<Fp_T, Dim_V> &operator()(population_t<Fp_T, Dim_V> &population) const override {
       population.clear();
       return population;
     }
@@ -232,10 +447,10 @@ namespace minimacore::genetic_algorithm {
     generational_selection_for_replacement() = default;
   };
 
-  template <floating_point_type Fp_T>
-  class truncation_selection_for_replacement : public base_selection_for_replacement<Fp_T> {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class truncation_selection_for_replacement : public base_selection_for_replacement<Fp_T, Dim_V> {
   public:
-    population_t<Fp_T> &operator()(population_t<Fp_T> &population) const override {
+    population_t<Fp_T, Dim_V> &operator()(population_t<Fp_T, Dim_V> &population) const override {
       sort(population);
       size_t elements_to_remove =
           _selection_size < population.size() ? population.size() - _selection_size : population.size();
@@ -244,18 +459,22 @@ namespace minimacore::genetic_algorithm {
       return population;
     }
 
+    [[nodiscard]] bool keeps_best() const override {
+      return true;
+    }
+
     explicit truncation_selection_for_replacement(size_t selection_size) : _selection_size(selection_size) {}
 
   private:
     size_t _selection_size{0};
   };
 
-  template <floating_point_type Fp_T>
-  class ranked_selection_for_replacement : public base_selection_for_replacement<Fp_T>, public ranked_selection {
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class ranked_selection_for_replacement : public base_selection_for_replacement<Fp_T, Dim_V>, public ranked_selection {
   public:
-    population_t<Fp_T> &operator()(population_t<Fp_T> &population) const override {
+    population_t<Fp_T, Dim_V> &operator()(population_t<Fp_T, Dim_V> &population) const override {
       const size_t initial_population_size = population.size();
-      ranked_selection_t<Fp_T> ranks = rank_population(population);
+      ranked_selection_t<Fp_T, Dim_V> ranks = rank_population(population);
       population.clear();
       switch (_select_by) {
       case select_by::RANKS:
@@ -2,12 +2,17 @@
 #ifndef MINIMACORE_SETUP_H
 #define MINIMACORE_SETUP_H
 
+#include "async_callbacks.h"
 #include "base_evaluation.h"
 #include "base_individual_generator.h"
 #include "genetic_operators.h"
+#include "local_search.h"
 #include "selection_operators.h"
+#include "surrogate.h"
 #include "termination_condition.h"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <thread>
 
@@ -24,18 +29,18 @@ namespace minimacore::genetic_algorithm {
 
 using std::function;
 
-template<floating_point_type F>
-class setup {
-  using selection_for_replacement_ptr = unique_ptr<base_selection_for_replacement<F>>;
-  using selection_for_reproduction_ptr = unique_ptr<base_selection_for_reproduction<F>>;
-  using mutation_ptr = unique_ptr<base_mutation<F>>;
-  using crossover_ptr = unique_ptr<base_crossover<F>>;
-  using genome_generator_ptr = unique_ptr<genome_generator<F>>;
-  using evaluation_t = unique_ptr<base_evaluation<F>>;
-  using evaluations_t = vector<evaluation_t>;
+/**
+ * @brief Configuration shared by every setup flavour: sizes, genome generation, termination, callbacks and threading.
+ * The genetic operators and evaluations are provided by the derived setup (see setup and static_setup).
+ */
+template<floating_point_type F, int Dim_V, typename Derived_T>
+class setup_base {
+  using genome_generator_ptr = unique_ptr<genome_generator<F, Dim_V>>;
   using termination_conditions_t = vector<termination_condition_ptr<F>>;
 
 public:
+  using value_type = F;
+  static constexpr int dimension = Dim_V;
 
   [[nodiscard]] size_t max_contiguous_failure_on_initialization() const
   {
@@ -57,6 +62,116 @@ public:
     _thread_count = n;
   }
 
+  /**
+   * @brief Whether the runner measures its phases with hardware counters, see runner::profiling_phase.
+   */
+  [[nodiscard]] bool hardware_counters() const
+  {
+    return _hardware_counters;
+  }
+
+  Derived_T& set_hardware_counters(bool enabled)
+  {
+    _hardware_counters = enabled;
+    return derived();
+  }
+
+  /**
+   * @brief Time limit of one evaluation, zero when unlimited.
+   */
+  [[nodiscard]] cancellation_token::clock_t::duration evaluation_time_limit() const
+  {
+    return _evaluation_time_limit;
+  }
+
+  /**
+   * @brief Limits the time of each evaluation. Once over the limit the runner stops waiting for it, cancels its token
+   * and discards the individual as if the evaluation had returned NaN. This holds for individual zero, the initial
+   * population and the local search too, where the evaluations of one refinement share a token.
+   *
+   * Cancellation is cooperative: evaluations must poll their token. The runner still waits for abandoned evaluations
+   * when it is destroyed, so one that never returns blocks the destruction of the runner.
+   */
+  template<typename Rep_T, typename Period_T>
+  Derived_T& set_evaluation_time_limit(std::chrono::duration<Rep_T, Period_T> limit)
+  {
+    _evaluation_time_limit = std::chrono::duration_cast<cancellation_token::clock_t::duration>(limit);
+    return derived();
+  }
+
+  /**
+   * @brief Whether offspring that cannot survive skip their remaining evaluations, see set_evaluation_pruning.
+   */
+  [[nodiscard]] bool evaluation_pruning() const
+  {
+    return _evaluation_pruning;
+  }
+
+  /**
+   * @brief Stops evaluating an offspring once the lower bounds of its remaining evaluations (see
+   * base_evaluation::lower_bound) show that it is worse than every survivor of the replacement. Only applies with a
+   * replacement keeping the best individuals, and assumes the fitness of an individual does not depend on the
+   * generation it is evaluated in. The rejected offspring fill the population with their bounds as objectives, but
+   * are left out of the statistics, of the selection for reproduction and of the replacement.
+   */
+  Derived_T& set_evaluation_pruning(bool enabled)
+  {
+    _evaluation_pruning = enabled;
+    return derived();
+  }
+
+  /**
+   * @brief Number of fidelity levels of the evaluations, 1 without successive halving.
+   */
+  [[nodiscard]] size_t fidelity_levels() const
+  {
+    return _fidelity_levels;
+  }
+
+  [[nodiscard]] double promotion_fraction() const
+  {
+    return _promotion_fraction;
+  }
+
+  /**
+   * @brief Successive halving over `levels` fidelity levels. Offspring are evaluated at the lowest fidelity (0), then
+   * the best `promotion_fraction` of each batch is evaluated again at fidelity 1, the best fraction of those at
+   * fidelity 2, and so on. Evaluations read the level from base_individual::fidelity(). Each individual keeps the
+   * fitness of the highest level it reached, which statistics and selection use.
+   */
+  Derived_T& set_successive_halving(size_t levels, double promotion_fraction = .5)
+  {
+    _fidelity_levels = std::max<size_t>(levels, 1);
+    _promotion_fraction = std::clamp(promotion_fraction, 0., 1.);
+    return derived();
+  }
+
+  /**
+   * @brief Most evaluations averaged per individual by racing, 1 when racing is disabled.
+   */
+  [[nodiscard]] size_t racing_samples() const
+  {
+    return _racing_samples;
+  }
+
+  [[nodiscard]] double racing_confidence() const
+  {
+    return _racing_confidence;
+  }
+
+  /**
+   * @brief Racing for noisy evaluations, with a replacement keeping the best individuals. Each generation, the
+   * individuals whose rank relative to the replacement boundary is uncertain are evaluated again, up to `max_samples`
+   * evaluations each, and their objectives hold the mean of their evaluations. A rank is uncertain while the mean
+   * fitness lies within `confidence` standard errors of the boundary; elites evaluated once are always evaluated again.
+   */
+  Derived_T& set_racing(size_t max_samples, double confidence = 2.)
+  {
+    _racing_samples = std::max<size_t>(max_samples, 1);
+    _racing_confidence = confidence;
+    return derived();
+  }
+
   [[nodiscard]] size_t population_size() const
   {
     return _population_size;
@@ -67,99 +182,142 @@ public:
     return _generations;
   }
 
-  const base_selection_for_reproduction<F>& selection_for_reproduction() const
+  const genome_generator<F, Dim_V>& get_genome_generator() const
   {
-    return *_selection_for_reproduction;
+    return *_genome_generator;
   }
 
-  const base_selection_for_replacement<F>& selection_for_replacement() const
+  /**
+   * @brief Local optimizer applied to the elites, may be null when no memetic refinement is configured.
+   */
+  const base_local_search<F, Dim_V>* local_search() const
   {
-    return *_selection_for_replacement;
+    return _local_search.get();
   }
 
-  const base_crossover<F>& crossover() const
+  [[nodiscard]] size_t local_search_elites() const
   {
-    return *_crossover;
+    return _local_search_elites;
   }
 
-  const base_mutation<F>& get_mutation() const
+  [[nodiscard]] size_t local_search_interval() const
   {
-    return *_mutation;
+    return _local_search_interval;
   }
 
-  const genome_generator<F>& get_genome_generator() const
+  /**
+   * @brief Surrogate model pre-screening the offspring, may be null when no surrogate is configured.
+   */
+  base_surrogate<F, Dim_V>* surrogate() const
   {
-    return *_genome_generator;
+    return _surrogate.get();
   }
 
-  const termination_conditions_t& termination_conditions() const
+  [[nodiscard]] size_t surrogate_candidate_factor() const
   {
-    return _termination_conditions;
+    return _surrogate_candidate_factor;
   }
 
-  const evaluations_t& evaluations() const
+  const termination_conditions_t& termination_conditions() const
   {
-    return _evaluations;
+    return _termination_conditions;
   }
 
-  setup<F>& set_population_size(size_t population_size)
+  Derived_T& set_population_size(size_t population_size)
   {
     _population_size = population_size;
-    return *this;
+    return derived();
   }
 
-  setup<F>& set_generations(size_t generations)
+  Derived_T& set_generations(size_t generations)
   {
     _generations = generations;
-    return *this;
+    return derived();
   }
 
-  setup<F>& set_selection_for_reproduction(selection_for_reproduction_ptr&& selection)
+  Derived_T& set_genome_generator(genome_generator_ptr&& genome_generator)
   {
-    _selection_for_reproduction = std::move(selection);
-    return *this;
+    _genome_generator = std::move(genome_generator);
+    return derived();
   }
 
-  setup<F>& set_selection_for_replacement(selection_for_replacement_ptr&& selection)
+  /**
+   * @brief Refines the best `elites` individuals with a local optimizer every `interval` generations.
+   */
+  Derived_T& set_local_search(local_search_ptr<F, Dim_V>&& local_search, size_t elites, size_t interval = 1)
   {
-    _selection_for_replacement = std::move(selection);
-    return *this;
+    _local_search = std::move(local_search);
+    _local_search_elites = elites;
+    _local_search_interval = interval ? interval : 1;
+    return derived();
   }
 
-  setup<F>& set_crossover(crossover_ptr&& crossover)
+  /**
+   * @brief Pre-screens the offspring with a surrogate model: `candidate_factor` times more offspring are bred than
+   * needed, and only the ones with the best predicted fitness are evaluated. The surrogate learns from every evaluation.
+   */
+  Derived_T& set_surrogate(surrogate_ptr<F, Dim_V>&& surrogate, size_t candidate_factor = 4)
   {
-    _crossover = std::move(crossover);
-    return *this;
+    _surrogate = std::move(surrogate);
+    _surrogate_candidate_factor = candidate_factor ? candidate_factor : 1;
+    return derived();
   }
 
-  setup<F>& set_mutation(mutation_ptr&& mutation)
+  Derived_T& add_termination(termination_condition_ptr<F>&& condition)
   {
-    _mutation = std::move(mutation);
-    return *this;
+    _termination_conditions.emplace_back(std::move(condition));
+    return derived();
   }
 
-  setup<F>& set_genome_generator(genome_generator_ptr&& genome_generator)
+  Derived_T& add_callback(function<void()>&& f)
   {
-    _genome_generator = std::move(genome_generator);
-    return *this;
+    _iteration_callbacks.emplace_back(std::move(f));
+    return derived();
   }
 
-  setup<F>& add_termination(termination_condition_ptr<F>&& condition)
+  /**
+   * @brief Adds a callback run on a background thread with a snapshot of each generation, see async_callbacks. Unlike
+   * the callbacks added with add_callback, it does not hold up the generation loop.
+   */
+  Derived_T& add_async_callback(typename async_callbacks<F, Dim_V>::callback_t&& f)
   {
-    _termination_conditions.emplace_back(std::move(condition));
-    return *this;
+    get_async_callbacks().add(std::move(f));
+    return derived();
   }
 
-  setup<F>& add_evaluation(evaluation_t&& evaluation)
+  /**
+   * @brief Bounds the snapshots waiting for the asynchronous callbacks and sets what happens when the bound is reached.
+   */
+  Derived_T& set_async_callback_queue(size_t capacity, overflow_policy policy)
   {
-    _evaluations.emplace_back(std::move(evaluation));
-    return *this;
+    get_async_callbacks().configure(capacity, policy);
+    return derived();
   }
 
-  setup<F>& add_callback(function<void()>&& f)
+  async_callbacks<F, Dim_V>& get_async_callbacks()
   {
-    _iteration_callbacks.emplace_back(std::move(f));
-    return *this;
+    if (!_async_callbacks) {
+      _async_callbacks = std::make_unique<async_callbacks<F, Dim_V>>();
+    }
+    return *_async_callbacks;
+  }
+
+  void publish_snapshot(size_t generation, const population_t<F, Dim_V>& population,
+                        const individual_ptr<F, Dim_V>& best) const
+  {
+    if (_async_callbacks) {
+      _async_callbacks->publish(generation, population, best);
+    }
+  }
+
+  /**
+   * @brief Waits for the asynchronous callbacks to process every published snapshot.
+   */
+  void drain_async_callbacks() const
+  {
+    if (_async_callbacks) {
+      _async_callbacks->drain();
+    }
   }
 
   void run_iteration_callbacks() const
@@ -180,54 +338,34 @@ public:
 #endif
   }
 
-  setup(setup&& other) noexcept
-          :_population_size(other._population_size),
-           _generations(other._generations),
-           _selection_for_replacement(std::move(other._selection_for_replacement)),
-           _selection_for_reproduction(std::move(other._selection_for_reproduction)),
-           _crossover(std::move(other._crossover)),
-           _mutation(std::move(other._mutation)),
-           _genome_generator(std::move(other._genome_generator)),
-           _termination_conditions(std::move(other._termination_conditions)),
-           _evaluations(std::move(other._evaluations)),
-           _thread_count(other._thread_count),
-           _max_contiguous_failure_on_initialization(other._max_contiguous_failure_on_initialization),
-           _iteration_callbacks(std::move(other._iteration_callbacks)) { }
+protected:
+  setup_base() = default;
 
-  setup(const setup& other) = delete;
+  setup_base(setup_base&& other) noexcept = default;
 
-  setup& operator=(setup&& other) noexcept
-  {
-    _population_size = other._population_size;
-    _generations = other._generations;
-    _selection_for_replacement = std::move(other._selection_for_replacement);
-    _selection_for_reproduction = std::move(other._selection_for_reproduction);
-    _crossover = std::move(other._crossover);
-    _mutation = std::move(other._mutation);
-    _genome_generator = std::move(other._genome_generator);
-    _termination_conditions = std::move(other._termination_conditions);
-    _evaluations = std::move(other._evaluations);
-    _thread_count = other._thread_count;
-    _max_contiguous_failure_on_initialization = other._max_contiguous_failure_on_initialization;
-    _iteration_callbacks = std::move(other._iteration_callbacks);
-  }
+  setup_base(const setup_base& other) = delete;
 
-  setup& operator=(const setup& other) = delete;
+  setup_base& operator=(setup_base&& other) noexcept = default;
 
-  setup() = default;
+  setup_base& operator=(const setup_base& other) = delete;
 
-  ~setup() = default;
+  ~setup_base() = default;
 
 private:
+  Derived_T& derived()
+  {
+    return static_cast<Derived_T&>(*this);
+  }
+
   size_t _population_size{0};
   size_t _generations{0};
-  selection_for_replacement_ptr _selection_for_replacement;
-  selection_for_reproduction_ptr _selection_for_reproduction;
-  crossover_ptr _crossover;
-  mutation_ptr _mutation;
   genome_generator_ptr _genome_generator;
+  local_search_ptr<F, Dim_V> _local_search;
+  size_t _local_search_elites{0};
+  size_t _local_search_interval{1};
   termination_conditions_t _termination_conditions;
-  evaluations_t _evaluations;
+  surrogate_ptr<F, Dim_V> _surrogate;
+  size_t _surrogate_candidate_factor{1};
   /*
    * Maximum contiguous failure on initialization. The variable sets the maximum number of individuals that can fail on
    * initialization before the algorithm is automatically stopped. This mechanism is intended to prevent impossible
@@ -235,7 +373,230 @@ private:
    */
   size_t _max_contiguous_failure_on_initialization = 300;
   size_t _thread_count = std::thread::hardware_concurrency();
+  bool _hardware_counters{false};
+  cancellation_token::clock_t::duration _evaluation_time_limit{0};
+  bool _evaluation_pruning{false};
+  size_t _fidelity_levels{1};
+  double _promotion_fraction{.5};
+  size_t _racing_samples{1};
+  double _racing_confidence{2.};
   vector<function<void()>> _iteration_callbacks;
+  unique_ptr<async_callbacks<F, Dim_V>> _async_callbacks;
+};
+
+/**
+ * @brief Run-time configurable setup: every operator is held behind a pointer to its abstract base.
+ */
+template<floating_point_type F, int Dim_V = dynamic_dimension>
+class setup : public setup_base<F, Dim_V, setup<F, Dim_V>> {
+  using selection_for_replacement_ptr = unique_ptr<base_selection_for_replacement<F, Dim_V>>;
+  using selection_for_reproduction_ptr = unique_ptr<base_selection_for_reproduction<F, Dim_V>>;
+  using mutation_ptr = unique_ptr<base_mutation<F, Dim_V>>;
+  using crossover_ptr = unique_ptr<base_crossover<F, Dim_V>>;
+  using evaluation_t = unique_ptr<base_evaluation<F, Dim_V>>;
+  using evaluations_t = vector<evaluation_t>;
+
+public:
+
+  const base_selection_for_reproduction<F, Dim_V>& selection_for_reproduction() const
+  {
+    return *_selection_for_reproduction;
+  }
+
+  const base_selection_for_replacement<F, Dim_V>& selection_for_replacement() const
+  {
+    return *_selection_for_replacement;
+  }
+
+  const base_crossover<F, Dim_V>& crossover() const
+  {
+    return *_crossover;
+  }
+
+  const base_mutation<F, Dim_V>& get_mutation() const
+  {
+    return *_mutation;
+  }
+
+  const evaluations_t& evaluations() const
+  {
+    return _evaluations;
+  }
+
+  setup<F, Dim_V>& set_selection_for_reproduction(selection_for_reproduction_ptr&& selection)
+  {
+    _selection_for_reproduction = std::move(selection);
+    return *this;
+  }
+
+  setup<F, Dim_V>& set_selection_for_replacement(selection_for_replacement_ptr&& selection)
+  {
+    _selection_for_replacement = std::move(selection);
+    return *this;
+  }
+
+  setup<F, Dim_V>& set_crossover(crossover_ptr&& crossover)
+  {
+    _crossover = std::move(crossover);
+    return *this;
+  }
+
+  setup<F, Dim_V>& set_mutation(mutation_ptr&& mutation)
+  {
+    _mutation = std::move(mutation);
+    return *this;
+  }
+
+  setup<F, Dim_V>& add_evaluation(evaluation_t&& evaluation)
+  {
+    _evaluations.emplace_back(std::move(evaluation));
+    schedule_evaluations();
+    return *this;
+  }
+
+  /*
+   * Pipeline used by the runner. static_setup provides the same functions with statically dispatched operators.
+   */
+
+  reproduction_selection_t<F, Dim_V> select_for_reproduction(population_t<F, Dim_V>& population) const
+  {
+    return (*_selection_for_reproduction)(population);
+  }
+
+  void select_for_replacement(population_t<F, Dim_V>& population) const
+  {
+    (*_selection_for_replacement)(population);
+  }
+
+  [[nodiscard]] bool replacement_keeps_best() const
+  {
+    return _selection_for_replacement->keeps_best();
+  }
+
+  [[nodiscard]] bool should_mutate() const
+  {
+    return _mutation->should_mutate();
+  }
+
+  void mutate(const base_individual<F, Dim_V>& individual, genome_t<F, Dim_V>& result) const
+  {
+    _mutation->apply(individual, result);
+  }
+
+  /**
+   * @brief Sparse form of mutate, see base_mutation::sample_delta.
+   */
+  bool sample_mutation(const base_individual<F, Dim_V>& individual, genome_delta<F>& delta) const
+  {
+    return _mutation->sample_delta(individual, delta);
+  }
+  
+  void cross(const base_individual<F, Dim_V>& a, const base_individual<F, Dim_V>& b, genome_t<F, Dim_V>& result) const
+  {
+    _crossover->apply(a, b, result);
+  }
+
+  /**
+   * @brief Runs every evaluation on the individual, cheapest first, stopping early once the token is cancelled. Once
+   * the partial fitness plus the lower bounds of the evaluations left exceeds `threshold`, the evaluations left are
+   * skipped, their objectives set to their bounds, and the individual is rejected.
+   * @return The number of objectives evaluated
+   */
+  size_t evaluate(base_individual<F, Dim_V>& individual, const cancellation_token& token = {},
+                  F threshold = std::numeric_limits<F>::infinity()) const
+  {
+    size_t counter = 0;
+    F partial = 0;
+    individual.set_rejected(false);
+    for (size_t stage = 0; stage < _schedule.size(); stage++) {
+      if (token.cancelled()) {
+        break;
+      }
+      if (std::isfinite(threshold) && partial + remaining_bound(stage) > threshold) {
+        reject(individual, stage);
+        break;
+      }
+      const auto& [index, offset] = _schedule[stage];
+      const size_t next = (*_evaluations[index])(individual, offset, token);
+      partial += individual.get_object_fitnesses().segment(Eigen::Index(offset), Eigen::Index(next - offset)).sum();
+      counter += next - offset;
+    }
+    return counter;
+  }
+
+  /**
+   * @return Whether an evaluation changed its scoring, see base_evaluation::begin_generation
+   */
+  bool begin_generation(size_t generation, size_t generations) const
+  {
+    bool changed = false;
+    for (auto& evaluation : _evaluations) {
+      changed |= evaluation->begin_generation(generation, generations);
+    }
+    return changed;
+  }
+
+  [[nodiscard]] size_t objective_count() const
+  {
+    return std::accumulate(_evaluations.begin(), _evaluations.end(), size_t{0},
+                           [](size_t i, const evaluation_t& eval) { return i + eval->objective_count(); });
+  }
+
+  setup(setup&& other) noexcept = default;
+
+  setup(const setup& other) = delete;
+
+  setup& operator=(setup&& other) noexcept = default;
+
+  setup& operator=(const setup& other) = delete;
+
+  setup() = default;
+
+  ~setup() = default;
+
+private:
+  /*
+   * Evaluations run by increasing relative cost, each paired with the index of its first objective
+   */
+  void schedule_evaluations()
+  {
+    _schedule.clear();
+    size_t offset = 0;
+    for (size_t i = 0; i < _evaluations.size(); i++) {
+      _schedule.emplace_back(i, offset);
+      offset += _evaluations[i]->objective_count();
+    }
+    std::ranges::stable_sort(_schedule, {},
+                             [this](const auto& stage) { return _evaluations[stage.first]->relative_cost(); });
+  }
+
+  F remaining_bound(size_t stage) const
+  {
+    F bound = 0;
+    for (; stage < _schedule.size(); stage++) {
+      bound += _evaluations[_schedule[stage].first]->lower_bound();
+    }
+    return bound;
+  }
+
+  void reject(base_individual<F, Dim_V>& individual, size_t stage) const
+  {
+    for (; stage < _schedule.size(); stage++) {
+      const auto& [index, offset] = _schedule[stage];
+      const size_t count = _evaluations[index]->objective_count();
+      for (size_t i = 0; i < count; i++) {
+        individual.set_objective_fitness(offset + i, _evaluations[index]->lower_bound() / F(count));
+      }
+    }
+    individual.set_rejected(true);
+  }
+
+  selection_for_replacement_ptr _selection_for_replacement;
+  selection_for_reproduction_ptr _selection_for_reproduction;
+  crossover_ptr _crossover;
+  mutation_ptr _mutation;
+  evaluations_t _evaluations;
+  vector<std::pair<size_t, size_t>> _schedule;
 };
 
 }
@@ -0,0 +1,250 @@
+
+#ifndef MINIMACORE_STATIC_SETUP_H
+#define MINIMACORE_STATIC_SETUP_H
+
+#include "setup.h"
+
+#include <array>
+#include <concepts>
+#include <numeric>
+#include <tuple>
+
+namespace minimacore::genetic_algorithm {
+
+  template <typename Op_T, typename Fp_T, int Dim_V>
+  concept reproduction_selection_operator = requires(const Op_T &op, population_t<Fp_T, Dim_V> &population) {
+    { op(population) } -> std::convertible_to<reproduction_selection_t<Fp_T, Dim_V>>;
+  };
+
+  template <typename Op_T, typename Fp_T, int Dim_V>
+  concept replacement_selection_operator =
+      requires(const Op_T &op, population_t<Fp_T, Dim_V> &population) { op(population); };
+
+  template <typename Op_T, typename Fp_T, int Dim_V>
+  concept crossover_operator =
+      requires(const Op_T &op, const base_individual<Fp_T, Dim_V> &parent, genome_t<Fp_T, Dim_V> &result) {
+        op.apply(parent, parent, result);
+      };
+
+  template <typename Op_T, typename Fp_T, int Dim_V>
+  concept mutation_operator =
+      requires(const Op_T &op, const base_individual<Fp_T, Dim_V> &parent, genome_t<Fp_T, Dim_V> &result) {
+        { op.should_mutate() } -> std::convertible_to<bool>;
+        op.apply(parent, result);
+      };
+
+  template <typename Op_T, typename Fp_T, int Dim_V>
+  concept evaluation_operator = requires(const Op_T &op, base_individual<Fp_T, Dim_V> &individual, size_t index) {
+    { op(individual, index) } -> std::convertible_to<size_t>;
+    { op.objective_count() } -> std::convertible_to<size_t>;
+  };
+
+  /**
+   * @brief Setup whose operators are fixed at compile time. The runner calls every operator through a qualified name,
+   * which bypasses virtual dispatch, so the whole per-offspring pipeline (variation and evaluation) can be inlined into
+   * a single kernel. Operators may still derive from the abstract bases, but any type modelling the operator concepts
+   * is accepted.
+   *
+   * Operators that are default-constructible are created with the setup; the others must be set before running.
+   * Evaluations are addressed by type, so every evaluation type may only appear once.
+   */
+  template <floating_point_type Fp_T, int Dim_V, typename Reproduction_T, typename Replacement_T, typename Crossover_T,
+            typename Mutation_T, typename... Evaluation_T>
+    requires reproduction_selection_operator<Reproduction_T, Fp_T, Dim_V> &&
+             replacement_selection_operator<Replacement_T, Fp_T, Dim_V> &&
+             crossover_operator<Crossover_T, Fp_T, Dim_V> && mutation_operator<Mutation_T, Fp_T, Dim_V> &&
+             (evaluation_operator<Evaluation_T, Fp_T, Dim_V> && ...)
+  class static_setup : public setup_base<Fp_T, Dim_V,
+                                         static_setup<Fp_T, Dim_V, Reproduction_T, Replacement_T, Crossover_T,
+                                                      Mutation_T, Evaluation_T...>> {
+  public:
+    const Reproduction_T &selection_for_reproduction() const {
+      return *_selection_for_reproduction;
+    }
+
+    const Replacement_T &selection_for_replacement() const {
+      return *_selection_for_replacement;
+    }
+
+    const Crossover_T &crossover() const {
+      return *_crossover;
+    }
+
+    const Mutation_T &get_mutation() const {
+      return *_mutation;
+    }
+
+    template <typename... Args_T> static_setup &set_selection_for_reproduction(Args_T &&...args) {
+      _selection_for_reproduction = std::make_unique<Reproduction_T>(std::forward<Args_T>(args)...);
+      return *this;
+    }
+
+    template <typename... Args_T> static_setup &set_selection_for_replacement(Args_T &&...args) {
+      _selection_for_replacement = std::make_unique<Replacement_T>(std::forward<Args_T>(args)...);
+      return *this;
+    }
+
+    template <typename... Args_T> static_setup &set_crossover(Args_T &&...args) {
+      _crossover = std::make_unique<Crossover_T>(std::forward<Args_T>(args)...);
+      return *this;
+    }
+
+    template <typename... Args_T> static_setup &set_mutation(Args_T &&...args) {
+      _mutation = std::make_unique<Mutation_T>(std::forward<Args_T>(args)...);
+      return *this;
+    }
+
+    template <typename Op_T, typename... Args_T> static_setup &set_evaluation(Args_T &&...args) {
+      std::get<unique_ptr<Op_T>>(_evaluations) = std::make_unique<Op_T>(std::forward<Args_T>(args)...);
+      return *this;
+    }
+
+    reproduction_selection_t<Fp_T, Dim_V> select_for_reproduction(population_t<Fp_T, Dim_V> &population) const {
+      return _selection_for_reproduction->Reproduction_T::operator()(population);
+    }
+
+    void select_for_replacement(population_t<Fp_T, Dim_V> &population) const {
+      _selection_for_replacement->Replacement_T::operator()(population);
+    }
+
+    [[nodiscard]] bool replacement_keeps_best() const {
+      if constexpr (requires { _selection_for_replacement->Replacement_T::keeps_best(); }) {
+        return _selection_for_replacement->Replacement_T::keeps_best();
+      } else {
+        return false;
+      }
+    }
+
+    [[nodiscard]] bool should_mutate() const {
+      return _mutation->Mutation_T::should_mutate();
+    }
+
+    void mutate(const base_individual<Fp_T, Dim_V> &individual, genome_t<Fp_T, Dim_V> &result) const {
+      _mutation->Mutation_T::apply(individual, result);
+    }
+
+    bool sample_mutation(const base_individual<Fp_T, Dim_V> &individual, genome_delta<Fp_T> &delta) const {
+      if constexpr (requires { _mutation->Mutation_T::sample_delta(individual, delta); }) {
+        return _mutation->Mutation_T::sample_delta(individual, delta);
+      } else {
+        return false;
+      }
+    }
+
+    void cross(const base_individual<Fp_T, Dim_V> &a, const base_individual<Fp_T, Dim_V> &b,
+               genome_t<Fp_T, Dim_V> &result) const {
+      _crossover->Crossover_T::apply(a, b, result);
+    }
+
+    /**
+     * @brief Runs every evaluation on the individual, stopping early once the token is cancelled. Evaluations that
+     * declare an operator taking the cancellation token receive it. The evaluations run in the order of the template
+     * arguments, so cheap ones should come first: once the partial fitness plus the lower bounds of the evaluations
+     * left exceeds `threshold`, the evaluations left are skipped, their objectives set to their bounds, and the
+     * individual is rejected.
+     * @return The number of objectives evaluated
+     */
+    size_t evaluate(base_individual<Fp_T, Dim_V> &individual, const cancellation_token &token = {},
+                    Fp_T threshold = std::numeric_limits<Fp_T>::infinity()) const {
+      size_t counter = 0;
+      individual.set_rejected(false);
+      std::apply(
+          [&individual, &counter, &token, threshold](const auto &...evaluation) {
+            const std::array<Fp_T, sizeof...(Evaluation_T)> bounds{lower_bound_of(*evaluation)...};
+            size_t stage = 0;
+            size_t offset = 0;
+            Fp_T partial = 0;
+            auto run_stage = [&](const auto &op) {
+              const size_t count = op.objective_count();
+              if (!token.cancelled() && !individual.is_rejected()) {
+                if (std::isfinite(threshold) &&
+                    partial + std::accumulate(bounds.begin() + long(stage), bounds.end(), Fp_T(0)) > threshold) {
+                  individual.set_rejected(true);
+                } else {
+                  evaluate_one(op, individual, offset, token);
+                  partial += individual.get_object_fitnesses().segment(Eigen::Index(offset), Eigen::Index(count)).sum();
+                  counter += count;
+                }
+              }
+              if (individual.is_rejected()) {
+                for (size_t i = 0; i < count; i++) {
+                  individual.set_objective_fitness(offset + i, bounds[stage] / Fp_T(count));
+                }
+              }
+              offset += count;
+              stage++;
+            };
+            (run_stage(*evaluation), ...);
+          },
+          _evaluations);
+      return counter;
+    }
+
+    bool begin_generation(size_t generation, size_t generations) const {
+      return std::apply(
+          [generation, generations](const auto &...evaluation) {
+            return (false | ... | begin_generation_of(*evaluation, generation, generations));
+          },
+          _evaluations);
+    }
+
+    [[nodiscard]] size_t objective_count() const {
+      return std::apply([](const auto &...evaluation) { return (size_t{0} + ... + evaluation->objective_count()); },
+                        _evaluations);
+    }
+
+    static_setup()
+        : _selection_for_reproduction(make_default<Reproduction_T>()),
+          _selection_for_replacement(make_default<Replacement_T>()), _crossover(make_default<Crossover_T>()),
+          _mutation(make_default<Mutation_T>()), _evaluations(make_default<Evaluation_T>()...) {}
+
+    static_setup(static_setup &&other) noexcept = default;
+    static_setup(const static_setup &other) = delete;
+    static_setup &operator=(static_setup &&other) noexcept = default;
+    static_setup &operator=(const static_setup &other) = delete;
+    ~static_setup() = default;
+
+  private:
+    template <typename Op_T>
+    static size_t evaluate_one(const Op_T &evaluation, base_individual<Fp_T, Dim_V> &individual, size_t index,
+                               const cancellation_token &token) {
+      if constexpr (requires { evaluation.Op_T::operator()(individual, index, token); }) {
+        return evaluation.Op_T::operator()(individual, index, token);
+      } else {
+        return evaluation.Op_T::operator()(individual, index);
+      }
+    }
+
+    template <typename Op_T> static Fp_T lower_bound_of(const Op_T &evaluation) {
+      if constexpr (requires { evaluation.Op_T::lower_bound(); }) {
+        return evaluation.Op_T::lower_bound();
+      } else {
+        return -std::numeric_limits<Fp_T>::infinity();
+      }
+    }
+
+    template <typename Op_T> static bool begin_generation_of(Op_T &evaluation, size_t generation, size_t generations) {
+      if constexpr (requires { evaluation.Op_T::begin_generation(generation, generations); }) {
+        return evaluation.Op_T::begin_generation(generation, generations);
+      } else {
+        return false;
+      }
+    }
+
+    template <typename Op_T> static unique_ptr<Op_T> make_default() {
+      if constexpr (std::default_initializable<Op_T>) {
+        return std::make_unique<Op_T>();
+      } else {
+        return nullptr;
+      }
+    }
+
+    unique_ptr<Reproduction_T> _selection_for_reproduction;
+    unique_ptr<Replacement_T> _selection_for_replacement;
+    unique_ptr<Crossover_T> _crossover;
+    unique_ptr<Mutation_T> _mutation;
+    std::tuple<unique_ptr<Evaluation_T>...> _evaluations;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_STATIC_SETUP_H
@@ -0,0 +1,171 @@
+
+#ifndef MINIMACORE_SURROGATE_H
+#define MINIMACORE_SURROGATE_H
+
+#include "base_individual.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Cheap model of the overall fitness, trained on the evaluated individuals and used to pre-screen offspring
+   * before the real evaluations.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension> class base_surrogate {
+  public:
+    /**
+     * @brief Predicted overall fitness of a genome, NaN while the model is untrained.
+     */
+    [[nodiscard]] virtual Fp_T predict(const genome_t<Fp_T, Dim_V> &genome) const = 0;
+
+    /**
+     * @brief Adds an evaluated sample to the model.
+     */
+    virtual void update(const genome_t<Fp_T, Dim_V> &genome, Fp_T fitness) = 0;
+
+    /**
+     * @brief Number of samples the model currently holds.
+     */
+    [[nodiscard]] virtual size_t size() const = 0;
+
+    base_surrogate() = default;
+    base_surrogate(const base_surrogate &) = delete;
+    base_surrogate(base_surrogate &&) = delete;
+    base_surrogate &operator=(const base_surrogate &) = delete;
+    base_surrogate &operator=(base_surrogate &&) = delete;
+    virtual ~base_surrogate() = default;
+  };
+
+  /**
+   * @brief Gaussian radial-basis-function interpolant over a sliding window of the latest `max_centers` samples:
+   *
+   *   f(x) = mean + sum_i w_i exp(-|x - c_i|^2 / (2 width^2)),   (K + regularization I) w = y - mean
+   *
+   * The Cholesky factor of the regularized kernel matrix is maintained incrementally: a new sample appends one row
+   * (a triangular solve) and the oldest sample leaves through a rank-one update, so each update costs O(n^2) instead of
+   * the O(n^3) of a refit.
+   */
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  class rbf_surrogate : public base_surrogate<Fp_T, Dim_V> {
+    using matrix_t = Eigen::Matrix<Fp_T, Eigen::Dynamic, Eigen::Dynamic>;
+    using vector_t = Eigen::Vector<Fp_T, Eigen::Dynamic>;
+
+  public:
+    [[nodiscard]] Fp_T predict(const genome_t<Fp_T, Dim_V> &genome) const override {
+      if (_count == 0) {
+        return std::numeric_limits<Fp_T>::quiet_NaN();
+      }
+      Fp_T result = _mean;
+      for (size_t i = 0; i < _count; i++) {
+        result += _weights(Eigen::Index(i)) * kernel(genome, _centers.col(Eigen::Index(i)));
+      }
+      return result;
+    }
+
+    void update(const genome_t<Fp_T, Dim_V> &genome, Fp_T fitness) override {
+      if (std::isnan(fitness)) {
+        return;
+      }
+      if (_count == 0) {
+        _centers.resize(genome.size(), Eigen::Index(_max_centers));
+      }
+      if (_count == _max_centers) {
+        remove_oldest();
+      }
+      const auto n = Eigen::Index(_count);
+      vector_t row(n);
+      for (Eigen::Index i = 0; i < n; i++) {
+        row(i) = kernel(genome, _centers.col(i));
+      }
+      auto factor = _cholesky.topLeftCorner(n, n).template triangularView<Eigen::Lower>();
+      factor.solveInPlace(row);
+      const Fp_T pivot = Fp_T(1) + _regularization - row.squaredNorm();
+      if (!(pivot > std::numeric_limits<Fp_T>::epsilon())) {
+        // The sample (nearly) duplicates the centers, the factor would no longer be positive definite
+        if (_count > 0) {
+          solve_weights();
+        }
+        return;
+      }
+      _cholesky.row(n).head(n) = row.transpose();
+      _cholesky(n, n) = std::sqrt(pivot);
+      _centers.col(n) = genome;
+      _values(n) = fitness;
+      _count++;
+      solve_weights();
+    }
+
+    [[nodiscard]] size_t size() const override {
+      return _count;
+    }
+
+    /**
+     * @param width Length scale of the Gaussian kernel, in genome units
+     * @param max_centers Number of latest samples kept in the model
+     * @param regularization Ridge added to the kernel diagonal, smooths noisy fitness values
+     */
+    explicit rbf_surrogate(Fp_T width, size_t max_centers = 256, Fp_T regularization = Fp_T(1E-6))
+        : _width(width), _max_centers(std::max<size_t>(max_centers, 1)), _regularization(regularization),
+          _cholesky(matrix_t::Zero(Eigen::Index(_max_centers), Eigen::Index(_max_centers))),
+          _values(vector_t::Zero(Eigen::Index(_max_centers))) {}
+
+  private:
+    template <typename Derived_T>
+    Fp_T kernel(const genome_t<Fp_T, Dim_V> &genome, const Eigen::MatrixBase<Derived_T> &center) const {
+      return std::exp(-(genome - center).squaredNorm() / (Fp_T(2) * _width * _width));
+    }
+
+    /**
+     * @brief Drops the first center. Removing the first row and column of L L^T leaves L22 L22^T + l21 l21^T, where
+     * l21 is the rest of the first column, so L22 gets a rank-one update.
+     */
+    void remove_oldest() {
+      const auto n = Eigen::Index(_count) - 1;
+      vector_t x = _cholesky.col(0).segment(1, n);
+      const matrix_t remaining = _cholesky.block(1, 1, n, n).template triangularView<Eigen::Lower>();
+      _cholesky.topLeftCorner(n, n) = remaining;
+      for (Eigen::Index k = 0; k < n; k++) {
+        const Fp_T diagonal = _cholesky(k, k);
+        const Fp_T r = std::hypot(diagonal, x(k));
+        const Fp_T c = r / diagonal;
+        const Fp_T s = x(k) / diagonal;
+        _cholesky(k, k) = r;
+        for (Eigen::Index i = k + 1; i < n; i++) {
+          _cholesky(i, k) = (_cholesky(i, k) + s * x(i)) / c;
+          x(i) = c * x(i) - s * _cholesky(i, k);
+        }
+      }
+      _cholesky.row(n).setZero();
+      _centers.leftCols(n) = _centers.middleCols(1, n).eval();
+      _values.head(n) = _values.segment(1, n).eval();
+      _count--;
+    }
+
+    void solve_weights() {
+      const auto n = Eigen::Index(_count);
+      _mean = _values.head(n).mean();
+      _weights = (_values.head(n).array() - _mean).matrix();
+      auto factor = _cholesky.topLeftCorner(n, n).template triangularView<Eigen::Lower>();
+      factor.solveInPlace(_weights);
+      factor.transpose().solveInPlace(_weights);
+    }
+
+    Fp_T _width;
+    size_t _max_centers;
+    Fp_T _regularization;
+    size_t _count{0};
+    matrix_t _cholesky;
+    matrix_t _centers;
+    vector_t _values;
+    vector_t _weights;
+    Fp_T _mean{0};
+  };
+
+  template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+  using surrogate_ptr = unique_ptr<base_surrogate<Fp_T, Dim_V>>;
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_SURROGATE_H
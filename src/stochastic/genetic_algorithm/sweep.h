@@ -0,0 +1,154 @@
+
+#ifndef MINIMACORE_SWEEP_H
+#define MINIMACORE_SWEEP_H
+
+#include "runner.h"
+
+#include <atomic>
+#include <thread>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Batch of independent runs, e.g. over seeds or hyperparameters. Every run evaluates on one shared thread pool
+   * instead of a pool of its own, so concurrent runs do not oversubscribe the machine. Each run queues its evaluations
+   * in its own lane of the pool and the workers serve the lanes in turn, so a run with a large population does not
+   * starve the others. Running several small runs at once keeps the workers busy where a single run could not.
+   *
+   * Runs are built from setup factories, called on the thread driving the run.
+   */
+  template <typename Setup_T> class sweep {
+  public:
+    using value_type = typename Setup_T::value_type;
+    static constexpr int dimension = Setup_T::dimension;
+    using runner_t = runner<value_type, dimension, Setup_T>;
+    using factory_t = function<Setup_T()>;
+
+    /**
+     * @brief Outcome of one run.
+     */
+    struct run_result {
+      typename runner_t::exit_flag flag{runner_t::exit_flag::FAILURE};
+      individual_ptr<value_type, dimension> best_individual;
+      size_t evaluation_count{0};
+      duration_t elapsed_time{0};
+      // Exported statistics of the run, one row per generation and one column per name
+      vector<string> columns;
+      Eigen::MatrixXd statistics;
+    };
+
+    sweep &add(factory_t &&factory) {
+      _factories.emplace_back(std::move(factory));
+      return *this;
+    }
+
+    [[nodiscard]] size_t size() const {
+      return _factories.size();
+    }
+
+    /**
+     * @brief Runs every added setup, at most `concurrent_runs` at a time, each driven by a thread of its own.
+     * @return The results, in the order the setups were added
+     */
+    const vector<run_result> &run() {
+      _results.clear();
+      _results.resize(_factories.size());
+      std::atomic_size_t next{0};
+      auto drive = [this, &next]() {
+        for (size_t i = next++; i < _factories.size(); i = next++) {
+          run_one(i);
+        }
+      };
+      const size_t driver_count = std::min(_concurrent_runs, _factories.size());
+      vector<std::thread> drivers;
+      drivers.reserve(driver_count);
+      for (size_t i = 0; i < driver_count; i++) {
+        drivers.emplace_back(drive);
+      }
+      for (auto &driver : drivers) {
+        driver.join();
+      }
+      return _results;
+    }
+
+    [[nodiscard]] const vector<run_result> &results() const {
+      return _results;
+    }
+
+    /**
+     * @brief Writes the statistics of every run as one table: a run and a generation column, then the union of the
+     * statistics columns of the runs, empty where a run has no value.
+     */
+    void export_statistics(const string &filename, char sep) const {
+      std::ofstream ofs(filename, std::ios::out);
+      if (!ofs.is_open() || ofs.bad()) {
+        return;
+      }
+      vector<string> columns;
+      for (const auto &result : _results) {
+        for (const auto &name : result.columns) {
+          if (std::ranges::find(columns, name) == columns.end()) {
+            columns.push_back(name);
+          }
+        }
+      }
+      ofs << "run" << sep << "generation";
+      for (const auto &name : columns) {
+        ofs << sep << name;
+      }
+      ofs << '\n';
+      ofs.precision(15);
+      for (size_t run = 0; run < _results.size(); run++) {
+        const auto &result = _results[run];
+        for (Eigen::Index generation = 0; generation < result.statistics.rows(); generation++) {
+          ofs << run << sep << generation;
+          for (const auto &name : columns) {
+            ofs << sep;
+            const auto column = std::ranges::find(result.columns, name);
+            if (column == result.columns.end()) {
+              continue;
+            }
+            const double value = result.statistics(generation, column - result.columns.begin());
+            if (!std::isnan(value)) {
+              ofs << value;
+            }
+          }
+          ofs << '\n';
+        }
+      }
+    }
+
+    /**
+     * @param thread_count Workers of the shared pool
+     * @param concurrent_runs Runs in progress at once, as many as workers by default
+     */
+    explicit sweep(size_t thread_count = std::thread::hardware_concurrency(), size_t concurrent_runs = 0)
+        : _threads(thread_count),
+          _concurrent_runs(concurrent_runs ? concurrent_runs : std::max<size_t>(thread_count, 1)) {}
+
+  private:
+    void run_one(size_t index) {
+      runner_t r(_factories[index](), _threads);
+      run_result &result = _results[index];
+      result.flag = r.run();
+      result.best_individual = r.get_best_individual();
+      result.elapsed_time = r.elapsed_time_ms();
+      const auto &statistics = r.get_statistics();
+      result.evaluation_count = statistics.evaluation_count();
+      result.columns = statistics.column_names();
+      result.statistics.resize(Eigen::Index(statistics.current_generation()), Eigen::Index(result.columns.size()));
+      for (Eigen::Index generation = 0; generation < result.statistics.rows(); generation++) {
+        for (Eigen::Index column = 0; column < result.statistics.cols(); column++) {
+          result.statistics(generation, column) = statistics.value(size_t(generation), size_t(column));
+        }
+      }
+    }
+
+    vector<factory_t> _factories;
+    vector<run_result> _results;
+    thread_pool _threads;
+    size_t _concurrent_runs;
+  };
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_SWEEP_H
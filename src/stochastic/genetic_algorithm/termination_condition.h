@@ -11,6 +11,15 @@ class termination_condition_base {
 public:
   virtual bool operator()(const evolution_statistics<F>& statistics) const = 0;
   
+  /**
+   * @brief Budgets are also checked by the runner while a generation is being evaluated, without waiting for the
+   * generation to complete. Their operator must then only read thread-safe statistics (evaluation count, elapsed time).
+   */
+  [[nodiscard]] virtual bool is_budget() const
+  {
+    return false;
+  }
+  
   virtual ~termination_condition_base() = default;
 };
 
@@ -80,6 +89,47 @@ private:
   F _min_selection_pressure{0.};
 };
 
+template<floating_point_type F>
+class evaluation_budget_termination : public termination_condition_base<F> {
+public:
+  bool operator()(const evolution_statistics<F>& statistics) const override
+  {
+    return statistics.evaluation_count() >= _maximum_evaluations;
+  }
+  
+  [[nodiscard]] bool is_budget() const override
+  {
+    return true;
+  }
+  
+  explicit evaluation_budget_termination(size_t maximum_evaluations) : _maximum_evaluations(maximum_evaluations)
+  {}
+
+private:
+  size_t _maximum_evaluations{0};
+};
+
+template<floating_point_type F>
+class wall_clock_termination : public termination_condition_base<F> {
+public:
+  bool operator()(const evolution_statistics<F>& statistics) const override
+  {
+    return statistics.elapsed_time() >= _time_limit;
+  }
+  
+  [[nodiscard]] bool is_budget() const override
+  {
+    return true;
+  }
+  
+  template<typename Rep_T, typename Period_T>
+  explicit wall_clock_termination(std::chrono::duration<Rep_T, Period_T> time_limit)
+          : _time_limit(std::chrono::duration_cast<std::chrono::steady_clock::duration>(time_limit))
+  {}
+
+private:
+  std::chrono::steady_clock::duration _time_limit;
+};
 
 }
 #endif //MINIMACORE_TERMINATION_CONDITION_H
@@ -0,0 +1,134 @@
+
+#ifndef MINIMACORE_VECTORIZED_RANDOM_H
+#define MINIMACORE_VECTORIZED_RANDOM_H
+
+#include <minimacore_concepts.h>
+
+#include <Eigen/Core>
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <random>
+
+namespace minimacore::genetic_algorithm {
+
+  /**
+   * @brief Genome length from which the single-genome operators switch from the scalar standard distributions to the
+   * block generator; below it the setup of the lanes outweighs the gain.
+   */
+  inline constexpr Eigen::Index vectorized_gene_threshold = 64;
+
+  /**
+   * @brief Random generator producing whole blocks of variates. It runs `Lanes_V` independent xorshift64* streams side
+   * by side so the state update of a block is a straight-line loop the compiler turns into SIMD code, and derives
+   * normal variates with the Box-Muller transform on Eigen arrays, whose log/sqrt/sin/cos are vectorized.
+   *
+   * The streams are not cryptographically strong; they are meant for variation operators.
+   */
+  template <floating_point_type Fp_T, size_t Lanes_V = 8> class vectorized_generator {
+    using array_t = Eigen::Array<Fp_T, Eigen::Dynamic, 1>;
+
+  public:
+    /**
+     * @brief Fills `out` with variates uniformly distributed in [low, high).
+     */
+    template <typename Derived_T> void uniform(Eigen::DenseBase<Derived_T> &out, Fp_T low, Fp_T high) {
+      const Fp_T scale = high - low;
+      const Eigen::Index size = out.size();
+      Eigen::Index i = 0;
+      std::array<Fp_T, Lanes_V> block;
+      for (; i < size; i += Eigen::Index(Lanes_V)) {
+        next_block(block);
+        const Eigen::Index count = std::min<Eigen::Index>(Lanes_V, size - i);
+        for (Eigen::Index lane = 0; lane < count; lane++) {
+          out.coeffRef(i + lane) = low + scale * block[lane];
+        }
+      }
+    }
+
+    /**
+     * @brief Fills `out` with normal variates of the given mean and standard deviation.
+     */
+    template <typename Derived_T> void normal(Eigen::DenseBase<Derived_T> &out, Fp_T mean, Fp_T std_dev) {
+      const Eigen::Index half = (out.size() + 1) / 2;
+      // The scratch arrays only grow, so a generator kept across calls stops allocating
+      if (_u1.size() < half) {
+        _u1.resize(half);
+        _u2.resize(half);
+      }
+      auto u1 = _u1.head(half);
+      auto u2 = _u2.head(half);
+      uniform(u1, Fp_T(0), Fp_T(1));
+      uniform(u2, Fp_T(0), Fp_T(2) * std::numbers::pi_v<Fp_T>);
+      // 1 - u lies in (0, 1], which keeps the logarithm finite
+      u1 = std_dev * (Fp_T(-2) * (Fp_T(1) - u1).log()).sqrt();
+      const Eigen::Index tail = out.size() - half;
+      out.derived().reshaped().head(half) = mean + u1 * u2.cos();
+      out.derived().reshaped().tail(tail) = mean + u1.head(tail) * u2.head(tail).sin();
+    }
+
+    /**
+     * @param seed Seed of the generator, 0 draws a seed from std::random_device
+     */
+    explicit vectorized_generator(std::uint64_t seed = 0) {
+      this->seed(seed);
+    }
+
+    /**
+     * @brief Restarts the streams from a seed, 0 drawing one from std::random_device.
+     */
+    void seed(std::uint64_t seed) {
+      if (seed == 0) {
+        std::random_device device;
+        seed = (std::uint64_t(device()) << 32) ^ device();
+      }
+      // splitmix64 spreads one seed over every lane, and never yields a zero state
+      for (auto &state : _state) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        std::uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state = (z ^ (z >> 31)) | 1;
+      }
+    }
+
+  private:
+    void next_block(std::array<Fp_T, Lanes_V> &block) {
+      for (size_t lane = 0; lane < Lanes_V; lane++) {
+        std::uint64_t x = _state[lane];
+        x ^= x >> 12;
+        x ^= x << 25;
+        x ^= x >> 27;
+        _state[lane] = x;
+        block[lane] = to_unit(x * 0x2545F4914F6CDD1DULL);
+      }
+    }
+
+    static Fp_T to_unit(std::uint64_t bits) {
+      if constexpr (sizeof(Fp_T) <= sizeof(float)) {
+        return Fp_T(bits >> 40) * Fp_T(0x1.0p-24);
+      } else {
+        return Fp_T(bits >> 11) * Fp_T(0x1.0p-53);
+      }
+    }
+
+    std::array<std::uint64_t, Lanes_V> _state;
+    array_t _u1;
+    array_t _u2;
+  };
+
+  /**
+   * @brief Block generator of the calling thread for the operator `Tag_T`, kept with its scratch arrays across calls.
+   * It draws its seed from std::random_device once per thread; a non-zero `seed` restarts it on every call instead, so
+   * a seeded operator draws the same variates on each call as it did with a generator of its own.
+   */
+  template <typename Tag_T, floating_point_type Fp_T> vectorized_generator<Fp_T> &thread_generator(std::uint64_t seed) {
+    thread_local vectorized_generator<Fp_T> generator;
+    if (seed != 0) {
+      generator.seed(seed);
+    }
+    return generator;
+  }
+
+} // namespace minimacore::genetic_algorithm
+#endif // MINIMACORE_VECTORIZED_RANDOM_H
@@ -0,0 +1,98 @@
+
+#ifndef MINIMACORE_CANCELLATION_TOKEN_H
+#define MINIMACORE_CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace minimacore {
+
+/**
+ * @brief Cooperative cancellation of a unit of work. Copies share their state: the owner keeps one copy to cancel the
+ * work, the work polls another with cancelled(). A token may also carry a deadline, armed when the work starts, after
+ * which it reads as cancelled.
+ *
+ * A default-constructed token has no state and is never cancelled, so passing it around costs nothing.
+ */
+class cancellation_token {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  /**
+   * @brief Creates a token that can be cancelled.
+   */
+  static cancellation_token create()
+  {
+    cancellation_token token;
+    token._state = std::make_shared<state>();
+    return token;
+  }
+
+  [[nodiscard]] bool cancellable() const
+  {
+    return _state != nullptr;
+  }
+
+  [[nodiscard]] bool cancelled() const
+  {
+    if (!_state) {
+      return false;
+    }
+    if (_state->cancelled.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    const clock_t::rep deadline = _state->deadline.load(std::memory_order_relaxed);
+    return deadline != no_deadline && clock_t::now().time_since_epoch().count() >= deadline;
+  }
+
+  void cancel() const
+  {
+    if (_state) {
+      _state->cancelled.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Starts the deadline, `limit` from now. A zero limit leaves the token without deadline.
+   */
+  void arm(clock_t::duration limit) const
+  {
+    if (_state && limit > clock_t::duration::zero()) {
+      _state->deadline.store((clock_t::now() + limit).time_since_epoch().count(), std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Whether the deadline was armed, i.e. the work has started.
+   */
+  [[nodiscard]] bool armed() const
+  {
+    return _state && _state->deadline.load(std::memory_order_relaxed) != no_deadline;
+  }
+
+  /**
+   * @brief Deadline of the work, clock_t::time_point::max() until armed.
+   */
+  [[nodiscard]] clock_t::time_point deadline() const
+  {
+    if (!armed()) {
+      return clock_t::time_point::max();
+    }
+    return clock_t::time_point(clock_t::duration(_state->deadline.load(std::memory_order_relaxed)));
+  }
+
+private:
+  static constexpr clock_t::rep no_deadline = 0;
+
+  struct state {
+    std::atomic<bool> cancelled{false};
+    std::atomic<clock_t::rep> deadline{no_deadline};
+  };
+
+  std::shared_ptr<state> _state;
+};
+
+} // minimacore
+
+#endif //MINIMACORE_CANCELLATION_TOKEN_H
@@ -0,0 +1,162 @@
+
+#ifndef MINIMACORE_EXECUTOR_H
+#define MINIMACORE_EXECUTOR_H
+
+#include "thread_pool.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace minimacore {
+
+/**
+ * @brief Scheduler a runner submits its tasks to. The runner only holds a reference, so it can run on a pool of its
+ * own, on a pool shared with other runners, or on the executor of a host application (see external_executor).
+ *
+ * Tasks submitted through an executor can reach it back with current(), so an evaluation can nest parallel work on the
+ * scheduler it runs on instead of creating threads of its own.
+ */
+class base_executor {
+public:
+  /**
+   * @brief Runs the task eventually, on any thread.
+   */
+  virtual void execute(std::function<void()>&& task) = 0;
+
+  /**
+   * @brief Number of tasks the executor runs at once.
+   */
+  [[nodiscard]] virtual size_t concurrency() const = 0;
+
+  /**
+   * @brief Runs one queued task on the calling thread, so a thread waiting on nested work helps instead of blocking.
+   * @return false if no task was run, always for executors that cannot hand out their queued tasks
+   */
+  virtual bool run_pending_task()
+  {
+    return false;
+  }
+
+  /**
+   * @brief Runs the task eventually as a task of this executor, whose nested reductions (see parallel_reduce) may split
+   * into `nested_width` parts.
+   */
+  void post(std::function<void()>&& task, size_t nested_width = 1)
+  {
+    execute([this, task = std::move(task), nested_width]() {
+      base_executor* const previous = std::exchange(_current, this);
+      const size_t previous_width = std::exchange(_nested_width, nested_width);
+      task();
+      _nested_width = previous_width;
+      _current = previous;
+    });
+  }
+
+  /**
+   * @brief Runs the task as with post and returns a future of its result.
+   */
+  template<typename F>
+  std::future<std::invoke_result_t<F>> submit(F&& func, size_t nested_width = 1)
+  {
+    using return_t = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<return_t()>>(std::forward<F>(func));
+    std::future<return_t> result = task->get_future();
+    post([task]() { (*task)(); }, nested_width);
+    return result;
+  }
+
+  /**
+   * @brief Executor of the task running on the calling thread, null outside tasks submitted with post or submit.
+   */
+  static base_executor* current()
+  {
+    return _current;
+  }
+
+  /**
+   * @brief Number of parts the nested reductions of the calling task may split into, 1 outside tasks.
+   */
+  static size_t nested_width()
+  {
+    return _nested_width;
+  }
+
+  base_executor() = default;
+
+  base_executor(const base_executor&) = delete;
+
+  base_executor& operator=(const base_executor&) = delete;
+
+  virtual ~base_executor() = default;
+
+private:
+  static inline thread_local base_executor* _current{nullptr};
+  static inline thread_local size_t _nested_width{1};
+};
+
+/**
+ * @brief Adapter over a thread_pool, which it does not own. Tasks go to a lane of their own, so executors sharing a
+ * pool are served in turn.
+ */
+class thread_pool_executor : public base_executor {
+public:
+  void execute(std::function<void()>&& task) override
+  {
+    _pool.post(_lane, std::move(task));
+  }
+
+  [[nodiscard]] size_t concurrency() const override
+  {
+    return _pool.thread_count();
+  }
+
+  bool run_pending_task() override
+  {
+    return _pool.run_pending_task();
+  }
+
+  explicit thread_pool_executor(thread_pool& pool) : _pool(pool), _lane(pool.open_lane())
+  {}
+
+  ~thread_pool_executor() override
+  {
+    _pool.close_lane(_lane);
+  }
+
+private:
+  thread_pool& _pool;
+  size_t _lane;
+};
+
+/**
+ * @brief Adapter over a scheduler provided by the caller, given as a function queueing a task on it. For example with
+ * an asio pool: `external_executor([&pool](auto&& task) { asio::post(pool, std::move(task)); }, threads)`.
+ */
+class external_executor : public base_executor {
+public:
+  using submit_t = std::function<void(std::function<void()>&&)>;
+
+  void execute(std::function<void()>&& task) override
+  {
+    _submit(std::move(task));
+  }
+
+  [[nodiscard]] size_t concurrency() const override
+  {
+    return _concurrency;
+  }
+
+  external_executor(submit_t submit, size_t concurrency) : _submit(std::move(submit)), _concurrency(concurrency)
+  {}
+
+private:
+  submit_t _submit;
+  size_t _concurrency;
+};
+
+} // minimacore
+
+#endif //MINIMACORE_EXECUTOR_H
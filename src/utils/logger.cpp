@@ -1,4 +1,213 @@
 
 #include "logger.h"
 
-namespace minimacore {} // namespace minimacore
\ No newline at end of file
+#include <array>
+#include <thread>
+
+namespace minimacore {
+
+namespace {
+
+std::string_view level_name(log_level level)
+{
+  switch (level) {
+    case log_level::TRACE:
+      return "[trace] ";
+    case log_level::DEBUG:
+      return "[debug] ";
+    case log_level::WARNING:
+      return "[warning] ";
+    case log_level::ERROR:
+      return "[error] ";
+    case log_level::INFO:
+    default:
+      return "";
+  }
+}
+
+}
+
+/**
+ * @brief Process-wide queue of records, drained by one background thread.
+ *
+ * The queue is a bounded multi-producer ring (Vyukov): each slot carries a sequence number telling whether it is free
+ * for the producer at a given position or filled for the consumer, so producers only compete on the head counter with a
+ * compare-and-swap and never lock.
+ */
+class log_dispatcher {
+public:
+  static log_dispatcher& instance()
+  {
+    static log_dispatcher dispatcher;
+    return dispatcher;
+  }
+
+  void push(const logger* target, log_level level, std::string_view text)
+  {
+    size_t position = _head.load(std::memory_order_relaxed);
+    slot* cell;
+    while (true) {
+      cell = &_slots[position % capacity];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+      if (difference == 0) {
+        if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // Full: wait for the background thread to free a slot
+        std::this_thread::yield();
+        position = _head.load(std::memory_order_relaxed);
+      } else {
+        position = _head.load(std::memory_order_relaxed);
+      }
+    }
+    cell->target = target;
+    cell->level = level;
+    cell->time = std::time({});
+    cell->length = text.copy(cell->text, sizeof(cell->text));
+    cell->sequence.store(position + 1, std::memory_order_release);
+    _published.fetch_add(1, std::memory_order_release);
+    _published.notify_one();
+  }
+
+  /**
+   * @brief Waits until every record pushed before the call has been written.
+   */
+  void flush()
+  {
+    const size_t target = _head.load(std::memory_order_acquire);
+    size_t written = _tail.load(std::memory_order_acquire);
+    while (written < target) {
+      _tail.wait(written, std::memory_order_acquire);
+      written = _tail.load(std::memory_order_acquire);
+    }
+  }
+
+  log_dispatcher(const log_dispatcher&) = delete;
+
+  log_dispatcher& operator=(const log_dispatcher&) = delete;
+
+  ~log_dispatcher()
+  {
+    _stop.store(true, std::memory_order_release);
+    _published.fetch_add(1, std::memory_order_release);
+    _published.notify_one();
+    _worker.join();
+  }
+
+private:
+  static constexpr size_t capacity = 1024;
+
+  struct slot {
+    std::atomic<size_t> sequence{0};
+    const logger* target{nullptr};
+    log_level level{log_level::INFO};
+    std::time_t time{0};
+    size_t length{0};
+    char text[log_record<log_level::INFO>::capacity]{};
+  };
+
+  log_dispatcher()
+  {
+    for (size_t i = 0; i < capacity; i++) {
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _worker = std::thread([this]() { drain(); });
+  }
+
+  bool pop()
+  {
+    const size_t position = _tail.load(std::memory_order_relaxed);
+    slot& cell = _slots[position % capacity];
+    if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+      return false;
+    }
+    _line.clear();
+    _line.append(timestamp(cell.time)).append(level_name(cell.level)).append(cell.text, cell.length);
+    if (_line.back() != '\n') {
+      _line.push_back('\n');
+    }
+    cell.target->write(_line);
+    cell.sequence.store(position + capacity, std::memory_order_release);
+    _tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  void drain()
+  {
+    while (true) {
+      const unsigned published = _published.load(std::memory_order_acquire);
+      bool written = false;
+      while (pop()) {
+        written = true;
+      }
+      if (written) {
+        _tail.notify_all();
+      }
+      if (_stop.load(std::memory_order_acquire) && _tail.load() == _head.load()) {
+        return;
+      }
+      // Sleeps until a record is published after the count was read
+      _published.wait(published, std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * @brief "[yyyy-mm-ddThh:mm:ssZ] ", formatted again only when the second changes.
+   */
+  std::string_view timestamp(std::time_t time)
+  {
+    if (time != _cached_time) {
+      _cached_time = time;
+      _cached_timestamp = "[yyyy-mm-ddThh:mm:ssZ] ";
+      std::strftime(_cached_timestamp.data() + 1, std::size("yyyy-mm-ddThh:mm:ssZ"), "%FT%TZ", std::gmtime(&time));
+      _cached_timestamp[_cached_timestamp.size() - 2] = ']';
+    }
+    return _cached_timestamp;
+  }
+
+  std::array<slot, capacity> _slots;
+  alignas(64) std::atomic<size_t> _head{0};
+  alignas(64) std::atomic<size_t> _tail{0};
+  alignas(64) std::atomic<unsigned> _published{0};
+  std::atomic<bool> _stop{false};
+  std::time_t _cached_time{-1};
+  std::string _cached_timestamp;
+  std::string _line;
+  std::thread _worker;
+};
+
+void logger::add_stream(std::ostream& stream)
+{
+  std::lock_guard lock(_streams_mutex);
+  _streams.push_back(&stream);
+}
+
+void logger::flush()
+{
+  log_dispatcher::instance().flush();
+}
+
+logger::~logger()
+{
+  if (_submitted.load(std::memory_order_relaxed)) {
+    flush();
+  }
+}
+
+void logger::submit(log_level level, std::string_view text) const
+{
+  _submitted.store(true, std::memory_order_relaxed);
+  log_dispatcher::instance().push(this, level, text);
+}
+
+void logger::write(std::string_view line) const
+{
+  std::lock_guard lock(_streams_mutex);
+  for (auto* stream : _streams) {
+    stream->write(line.data(), std::streamsize(line.size()));
+  }
+}
+
+} // minimacore
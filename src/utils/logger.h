@@ -2,34 +2,217 @@
 #ifndef MINIMACORE_LOGGER_H
 #define MINIMACORE_LOGGER_H
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
 #include <ctime>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/*
+ * Lowest severity compiled in, as the value of a log_level. Records below it are removed at compile time, e.g.
+ * -DMINIMACORE_LOG_LEVEL=2 keeps INFO and above.
+ */
+#ifndef MINIMACORE_LOG_LEVEL
+  #define MINIMACORE_LOG_LEVEL 0
+#endif
 
 namespace minimacore {
 
 using std::vector;
 
-class logger {
+enum class log_level : std::uint8_t {
+  TRACE = 0,
+  DEBUG,
+  INFO,
+  WARNING,
+  ERROR,
+  OFF,
+};
+
+inline constexpr log_level compiled_log_level = log_level(MINIMACORE_LOG_LEVEL);
 
+class logger;
+
+/**
+ * @brief One log message, built with operator<< and submitted as a whole when the record is destroyed, i.e. at the end
+ * of the logging statement, so messages from concurrent threads never interleave. Messages are limited to
+ * `capacity` characters; longer ones are cut and end with `truncation_marker`.
+ */
+template<log_level Level>
+class log_record {
 public:
+  static constexpr size_t capacity = 240;
+
+  static constexpr std::string_view truncation_marker = "...";
+
   template<typename T>
-  logger& operator<<(T message)
+  log_record& operator<<(const T& value)
   {
-    for (auto& stream : _streams) {
-      if (stream) *stream << message;
+    if constexpr (Level >= compiled_log_level) {
+      if (_logger) {
+        append(value);
+      }
     }
     return *this;
   }
-  
-  void add_stream(std::ostream& stream)
+
+  log_record(log_record&& other) noexcept
+          : _logger(std::exchange(other._logger, nullptr)), _length(other._length), _truncated(other._truncated)
+  {
+    std::copy_n(other._text, _length, _text);
+  }
+
+  log_record(const log_record&) = delete;
+
+  log_record& operator=(const log_record&) = delete;
+
+  ~log_record();
+
+private:
+  friend class logger;
+
+  explicit log_record(const logger* target);
+
+  void append(std::string_view text)
+  {
+    const size_t count = std::min(text.size(), capacity - _length);
+    text.copy(_text + _length, count);
+    _length += count;
+    _truncated = _truncated || count < text.size();
+  }
+
+  template<typename T>
+  void append(const T& value)
+  {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      append(std::string_view(value));
+    } else if constexpr (std::same_as<T, char>) {
+      append(std::string_view(&value, 1));
+    } else if constexpr (std::is_arithmetic_v<T> && !std::same_as<T, bool>) {
+      std::to_chars_result result;
+      if constexpr (std::is_floating_point_v<T>) {
+        // Same digits as the default stream formatting
+        result = std::to_chars(_text + _length, _text + capacity, value, std::chars_format::general, 6);
+      } else {
+        result = std::to_chars(_text + _length, _text + capacity, value);
+      }
+      if (result.ec == std::errc()) {
+        _length = size_t(result.ptr - _text);
+      } else {
+        _truncated = true;
+      }
+    } else {
+      thread_local std::ostringstream stream;
+      stream.str({});
+      stream << value;
+      append(std::string_view(stream.view()));
+    }
+  }
+
+  const logger* _logger;
+  size_t _length{0};
+  bool _truncated{false};
+  char _text[capacity];
+};
+
+/**
+ * @brief Asynchronous logger. Records are pushed into a process-wide, lock-free ring buffer and written to the
+ * registered streams by a background thread, which prefixes them with a cached timestamp and their level. Logging is
+ * safe from any thread: producers only contend on one atomic counter, and never wait on the streams unless the ring is
+ * full.
+ *
+ * Records below the compile-time level (MINIMACORE_LOG_LEVEL) cost nothing; records below the run-time level
+ * (set_level) are dropped before being formatted.
+ */
+class logger {
+
+public:
+  template<log_level Level>
+  log_record<Level> log() const
+  {
+    return log_record<Level>(Level >= compiled_log_level && enabled(Level) ? this : nullptr);
+  }
+
+  log_record<log_level::TRACE> trace() const
+  {
+    return log<log_level::TRACE>();
+  }
+
+  log_record<log_level::DEBUG> debug() const
+  {
+    return log<log_level::DEBUG>();
+  }
+
+  log_record<log_level::INFO> info() const
+  {
+    return log<log_level::INFO>();
+  }
+
+  log_record<log_level::WARNING> warning() const
+  {
+    return log<log_level::WARNING>();
+  }
+
+  log_record<log_level::ERROR> error() const
+  {
+    return log<log_level::ERROR>();
+  }
+
+  /**
+   * @brief Starts an INFO record, so `log << a << b;` is written as one message.
+   */
+  template<typename T>
+  log_record<log_level::INFO> operator<<(const T& message) const
+  {
+    auto record = info();
+    record << message;
+    return record;
+  }
+
+  [[nodiscard]] bool enabled(log_level level) const
+  {
+    return level >= _level.load(std::memory_order_relaxed);
+  }
+
+  void set_level(log_level level)
   {
-    _streams.push_back(&stream);
+    _level.store(level, std::memory_order_relaxed);
   }
-  
-  explicit logger() = default;
 
+  [[nodiscard]] log_level level() const
+  {
+    return _level.load(std::memory_order_relaxed);
+  }
+
+  void add_stream(std::ostream& stream);
+
+  /**
+   * @brief Blocks until every record submitted so far, by any logger, has been written.
+   */
+  static void flush();
+
+  explicit logger(log_level level = log_level::INFO) : _level(level)
+  {}
+
+  logger(const logger&) = delete;
+
+  logger& operator=(const logger&) = delete;
+
+  /**
+   * @brief Flushes the pending records if the logger submitted any, as they refer to it.
+   */
+  ~logger();
+
+  [[deprecated("records are timestamped by the logger")]]
   static inline std::string uts_timestamp() {
     std::time_t time = std::time({});
     std::string timeString{"yyyy-mm-ddThh:mm:ssZ"};
@@ -37,18 +220,54 @@ public:
     return timeString;
   }
 
+  [[deprecated("records are timestamped by the logger")]]
   static inline std::string wrapped_uts_timestamp() {
     std::time_t time = std::time({});
     std::string timeString{"yyyy-mm-ddThh:mm:ssZ"};
     std::strftime(timeString.data(), std::size("yyyy-mm-ddThh:mm:ssZ"), "%FT%TZ", std::gmtime(&time));
     return "[" + timeString + "] ";
   }
-  
+
 private:
-  
+  template<log_level>
+  friend class log_record;
+
+  friend class log_dispatcher;
+
+  /**
+   * @brief Queues a message, called by log_record.
+   */
+  void submit(log_level level, std::string_view text) const;
+
+  /**
+   * @brief Writes a formatted line to the streams, called by the background thread.
+   */
+  void write(std::string_view line) const;
+
+  std::atomic<log_level> _level;
+  mutable std::atomic<bool> _submitted{false};
+  mutable std::mutex _streams_mutex;
   vector<std::ostream*> _streams;
 };
 
+template<log_level Level>
+log_record<Level>::log_record(const logger* target) : _logger(target)
+{}
+
+template<log_level Level>
+log_record<Level>::~log_record()
+{
+  if constexpr (Level >= compiled_log_level) {
+    if (_logger) {
+      if (_truncated) {
+        truncation_marker.copy(_text + capacity - truncation_marker.size(), truncation_marker.size());
+        _length = capacity;
+      }
+      _logger->submit(Level, std::string_view(_text, _length));
+    }
+  }
+}
+
 } // minimacore
 
 #endif //MINIMACORE_LOGGER_H
@@ -0,0 +1,204 @@
+
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+  #define MINIMACORE_HAS_MMAP 1
+#endif
+
+namespace minimacore {
+
+#ifdef MINIMACORE_HAS_MMAP
+
+namespace {
+
+int to_advice(mapped_file::access_hint hint)
+{
+  switch (hint) {
+    case mapped_file::access_hint::SEQUENTIAL:
+      return MADV_SEQUENTIAL;
+    case mapped_file::access_hint::RANDOM:
+      return MADV_RANDOM;
+    case mapped_file::access_hint::WILL_NEED:
+      return MADV_WILLNEED;
+    case mapped_file::access_hint::NORMAL:
+    default:
+      return MADV_NORMAL;
+  }
+}
+
+}
+
+mapped_file::mapped_file(const std::string& path, size_t size, bool huge_pages) : _huge_pages(huge_pages)
+{
+  // Only a mapping of a given size may create the file, an empty one could not be mapped anyway
+  _fd = size == 0 ? ::open(path.c_str(), O_RDWR) : ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (_fd < 0) {
+    return;
+  }
+  if (size == 0) {
+    const off_t end = ::lseek(_fd, 0, SEEK_END);
+    size = end > 0 ? size_t(end) : 0;
+  } else if (::ftruncate(_fd, off_t(size)) != 0) {
+    close();
+    return;
+  }
+  if (!map(size)) {
+    close();
+  }
+}
+
+mapped_file mapped_file::open_read_only(const std::string& path)
+{
+  mapped_file file;
+  file._writable = false;
+  file._fd = ::open(path.c_str(), O_RDONLY);
+  if (file._fd < 0) {
+    return file;
+  }
+  const off_t end = ::lseek(file._fd, 0, SEEK_END);
+  if (end <= 0 || !file.map(size_t(end))) {
+    file.close();
+  }
+  return file;
+}
+
+bool mapped_file::map(size_t size)
+{
+  if (size == 0) {
+    return false;
+  }
+  const int protection = _writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  void* address = ::mmap(nullptr, size, protection, MAP_SHARED, _fd, 0);
+  if (address == MAP_FAILED) {
+    return false;
+  }
+  _data = static_cast<std::byte*>(address);
+  _size = size;
+#ifdef MADV_HUGEPAGE
+  if (_huge_pages) {
+    ::madvise(_data, _size, MADV_HUGEPAGE);
+  }
+#endif
+  return true;
+}
+
+bool mapped_file::resize(size_t size)
+{
+  if (_fd < 0 || !_writable) {
+    return false;
+  }
+  if (_data) {
+    ::munmap(_data, _size);
+    _data = nullptr;
+    _size = 0;
+  }
+  if (::ftruncate(_fd, off_t(size)) != 0) {
+    return false;
+  }
+  return map(size);
+}
+
+void mapped_file::advise(access_hint hint)
+{
+  if (_data) {
+    ::madvise(_data, _size, to_advice(hint));
+  }
+}
+
+void mapped_file::advise(size_t offset, size_t length, access_hint hint)
+{
+  if (!_data || offset >= _size) {
+    return;
+  }
+  const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+  const size_t first = offset / page * page;
+  const size_t last = std::min(offset + length, _size);
+  ::madvise(_data + first, last - first, to_advice(hint));
+}
+
+void mapped_file::flush()
+{
+  if (_data) {
+    ::msync(_data, _size, MS_SYNC);
+  }
+}
+
+void mapped_file::close()
+{
+  if (_data) {
+    ::munmap(_data, _size);
+  }
+  if (_fd >= 0) {
+    ::close(_fd);
+  }
+  _data = nullptr;
+  _size = 0;
+  _fd = -1;
+}
+
+#else
+
+mapped_file::mapped_file(const std::string&, size_t, bool huge_pages) : _huge_pages(huge_pages)
+{}
+
+mapped_file mapped_file::open_read_only(const std::string&)
+{
+  mapped_file file;
+  file._writable = false;
+  return file;
+}
+
+bool mapped_file::map(size_t)
+{
+  return false;
+}
+
+bool mapped_file::resize(size_t)
+{
+  return false;
+}
+
+void mapped_file::advise(access_hint)
+{}
+
+void mapped_file::advise(size_t, size_t, access_hint)
+{}
+
+void mapped_file::flush()
+{}
+
+void mapped_file::close()
+{}
+
+#endif
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+        : _fd(std::exchange(other._fd, -1)), _data(std::exchange(other._data, nullptr)),
+          _size(std::exchange(other._size, 0)), _huge_pages(other._huge_pages), _writable(other._writable)
+{}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+  if (this != &other) {
+    close();
+    _fd = std::exchange(other._fd, -1);
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+    _huge_pages = other._huge_pages;
+    _writable = other._writable;
+  }
+  return *this;
+}
+
+mapped_file::~mapped_file()
+{
+  close();
+}
+
+} // minimacore
@@ -0,0 +1,112 @@
+
+#ifndef MINIMACORE_MAPPED_FILE_H
+#define MINIMACORE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace minimacore {
+
+/**
+ * @brief Read-write, file-backed shared memory mapping. Like the standard streams, a failure to open or map the file
+ * does not throw: it leaves the object closed, which is checked with is_open().
+ *
+ * Only POSIX systems provide mappings; elsewhere every mapped_file stays closed.
+ */
+class mapped_file {
+public:
+  enum class access_hint : std::uint8_t {
+    NORMAL = 0,
+    SEQUENTIAL,
+    RANDOM,
+    WILL_NEED,
+  };
+
+  [[nodiscard]] bool is_open() const
+  {
+    return _data != nullptr;
+  }
+
+  std::byte* data()
+  {
+    return _data;
+  }
+
+  [[nodiscard]] const std::byte* data() const
+  {
+    return _data;
+  }
+
+  [[nodiscard]] size_t size() const
+  {
+    return _size;
+  }
+
+  [[nodiscard]] bool is_writable() const
+  {
+    return _writable;
+  }
+
+  /**
+   * @brief Grows or shrinks the file and remaps it. Pointers into the previous mapping are invalidated. Fails on
+   * read-only mappings.
+   */
+  bool resize(size_t size);
+
+  /**
+   * @brief Access pattern hint for the whole mapping.
+   */
+  void advise(access_hint hint);
+
+  /**
+   * @brief Access pattern hint for a byte range, rounded outwards to whole pages.
+   */
+  void advise(size_t offset, size_t length, access_hint hint);
+
+  /**
+   * @brief Writes dirty pages back to the file.
+   */
+  void flush();
+
+  void close();
+
+  /**
+   * @brief Maps `path`, creating it if needed.
+   * @param size Size of the mapping in bytes. The file is resized to it; 0 opens an existing file without creating
+   * it, and keeps its size.
+   * @param huge_pages Requests transparent huge pages for the mapping where the system supports them
+   */
+  explicit mapped_file(const std::string& path, size_t size = 0, bool huge_pages = true);
+
+  /**
+   * @brief Maps an existing file for reading only, e.g. a dataset shared by every thread. Writing through data()
+   * faults.
+   */
+  static mapped_file open_read_only(const std::string& path);
+
+  mapped_file() = default;
+
+  mapped_file(mapped_file&& other) noexcept;
+
+  mapped_file& operator=(mapped_file&& other) noexcept;
+
+  mapped_file(const mapped_file&) = delete;
+
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file();
+
+private:
+  bool map(size_t size);
+
+  int _fd{-1};
+  std::byte* _data{nullptr};
+  size_t _size{0};
+  bool _huge_pages{false};
+  bool _writable{true};
+};
+
+} // minimacore
+
+#endif //MINIMACORE_MAPPED_FILE_H
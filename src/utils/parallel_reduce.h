@@ -0,0 +1,83 @@
+
+#ifndef MINIMACORE_PARALLEL_REDUCE_H
+#define MINIMACORE_PARALLEL_REDUCE_H
+
+#include "executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace minimacore {
+
+/**
+ * @brief Reduces `map(begin, end)` over the parts of [0, count), split across the executor of the calling task:
+ *
+ *   reduce(...reduce(reduce(identity, map(0, e_0)), map(e_0, e_1))..., map(e_k, count))
+ *
+ * The range splits into at most base_executor::nested_width() parts of at least `grain` elements, so outside executor
+ * tasks, or when the engine gives the task no width, the whole range is mapped inline. The parts are queued on the
+ * executor, but the calling thread claims and maps the parts no worker has started yet, then runs other queued tasks
+ * while the remaining parts complete. A reduction therefore never waits on work that nobody runs, and nested
+ * reductions cannot deadlock the pool even when every worker waits on one.
+ *
+ * The parts are reduced in order, so a deterministic map gives a deterministic result for a given width.
+ */
+template<typename T, typename Map_T, typename Reduce_T>
+T parallel_reduce(size_t count, T identity, Map_T map, Reduce_T reduce, size_t grain = 1)
+{
+  base_executor* const executor = base_executor::current();
+  grain = std::max<size_t>(grain, 1);
+  const size_t parts = std::min(base_executor::nested_width(), (count + grain - 1) / grain);
+  if (!executor || parts <= 1) {
+    return reduce(std::move(identity), map(size_t{0}, count));
+  }
+
+  struct part_state {
+    std::atomic<bool> claimed{false};
+    T result;
+  };
+  struct reduction_state {
+    std::vector<part_state> parts;
+    std::atomic_size_t remaining;
+    Map_T map;
+
+    reduction_state(size_t count, Map_T&& f) : parts(count), remaining(count), map(std::move(f))
+    {}
+  };
+  auto state = std::make_shared<reduction_state>(parts, std::move(map));
+  auto part_begin = [count, parts](size_t part) { return count * part / parts; };
+  auto run_part = [state, part_begin](size_t part) {
+    part_state& p = state->parts[part];
+    if (p.claimed.exchange(true, std::memory_order_acquire)) {
+      return;
+    }
+    p.result = state->map(part_begin(part), part_begin(part + 1));
+    if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      state->remaining.notify_all();
+    }
+  };
+  // The first part stays on the calling thread
+  for (size_t part = 1; part < parts; part++) {
+    executor->post([run_part, part]() { run_part(part); });
+  }
+  for (size_t part = 0; part < parts; part++) {
+    run_part(part);
+  }
+  // Parts still running on other threads: help with the queued tasks meanwhile
+  for (size_t remaining = state->remaining.load(std::memory_order_acquire); remaining > 0;
+       remaining = state->remaining.load(std::memory_order_acquire)) {
+    if (!executor->run_pending_task()) {
+      state->remaining.wait(remaining, std::memory_order_acquire);
+    }
+  }
+  for (part_state& p : state->parts) {
+    identity = reduce(std::move(identity), std::move(p.result));
+  }
+  return identity;
+}
+
+} // minimacore
+
+#endif //MINIMACORE_PARALLEL_REDUCE_H
@@ -0,0 +1,189 @@
+
+#include "perf_counters.h"
+
+#if defined(__linux__)
+  #include <cstring>
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #define MINIMACORE_HAS_PERF_EVENTS 1
+#endif
+
+namespace minimacore {
+
+const char* perf_counter_group::name(perf_event event)
+{
+  switch (event) {
+    case perf_event::CYCLES:
+      return "cycles";
+    case perf_event::INSTRUCTIONS:
+      return "instructions";
+    case perf_event::CACHE_MISSES:
+      return "cache_misses";
+    case perf_event::BRANCH_MISSES:
+      return "branch_misses";
+    case perf_event::TASK_CLOCK:
+    default:
+      return "task_clock_ns";
+  }
+}
+
+#ifdef MINIMACORE_HAS_PERF_EVENTS
+
+namespace {
+
+int open_event(perf_event event, int group)
+{
+  perf_event_attr attributes{};
+  attributes.size = sizeof(attributes);
+  attributes.type = PERF_TYPE_HARDWARE;
+  switch (event) {
+    case perf_event::CYCLES:
+      attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case perf_event::INSTRUCTIONS:
+      attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case perf_event::CACHE_MISSES:
+      attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+      break;
+    case perf_event::BRANCH_MISSES:
+      attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case perf_event::TASK_CLOCK:
+      attributes.type = PERF_TYPE_SOFTWARE;
+      attributes.config = PERF_COUNT_SW_TASK_CLOCK;
+      break;
+  }
+  attributes.disabled = group < 0 ? 1 : 0;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Calling thread, any CPU
+  return int(::syscall(SYS_perf_event_open, &attributes, 0, -1, group, 0));
+}
+
+}
+
+perf_counter_group::perf_counter_group()
+{
+  _fds.fill(-1);
+  for (size_t i = 0; i < perf_event_count; i++) {
+    const int fd = open_event(perf_event(i), _leader);
+    if (fd < 0) {
+      continue;
+    }
+    if (_leader < 0) {
+      _leader = fd;
+    }
+    _fds[i] = fd;
+    _positions[i] = _open_count++;
+  }
+  if (is_open()) {
+    ::ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+bool perf_counter_group::read(perf_sample& sample) const
+{
+  sample = {};
+  if (!is_open()) {
+    return false;
+  }
+  // nr, time enabled, time running, then one value per open event
+  std::array<std::uint64_t, 3 + perf_event_count> buffer{};
+  if (::read(_leader, buffer.data(), sizeof(buffer)) < ssize_t(3 * sizeof(std::uint64_t))) {
+    return false;
+  }
+  const double scale = buffer[2] > 0 ? double(buffer[1]) / double(buffer[2]) : 1.;
+  for (size_t i = 0; i < perf_event_count; i++) {
+    if (_fds[i] >= 0) {
+      sample.values[i] = double(buffer[3 + _positions[i]]) * scale;
+    }
+  }
+  return true;
+}
+
+perf_counter_group::~perf_counter_group()
+{
+  for (int fd : _fds) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+}
+
+#else
+
+perf_counter_group::perf_counter_group()
+{
+  _fds.fill(-1);
+}
+
+bool perf_counter_group::read(perf_sample& sample) const
+{
+  sample = {};
+  return false;
+}
+
+perf_counter_group::~perf_counter_group() = default;
+
+#endif
+
+namespace {
+
+perf_counter_group& thread_group()
+{
+  thread_local perf_counter_group group;
+  return group;
+}
+
+}
+
+perf_phase_counters::scope::scope(perf_phase_counters* counters, size_t phase) : _counters(counters), _phase(phase)
+{
+  if (_counters) {
+    thread_group().read(_begin);
+  }
+}
+
+perf_phase_counters::scope::~scope()
+{
+  if (_counters) {
+    perf_sample end;
+    thread_group().read(end);
+    _counters->add(_phase, _begin, end);
+  }
+}
+
+bool perf_phase_counters::open()
+{
+  const perf_counter_group& group = thread_group();
+  for (size_t i = 0; i < perf_event_count; i++) {
+    _available[i] = group.available(perf_event(i));
+  }
+  return group.is_open();
+}
+
+perf_sample perf_phase_counters::take(size_t phase)
+{
+  perf_sample sample;
+  for (size_t i = 0; i < perf_event_count; i++) {
+    sample.values[i] = _totals[phase][i].exchange(0., std::memory_order_relaxed);
+  }
+  return sample;
+}
+
+perf_phase_counters::perf_phase_counters(size_t phase_count) : _totals(phase_count)
+{}
+
+void perf_phase_counters::add(size_t phase, const perf_sample& begin, const perf_sample& end)
+{
+  for (size_t i = 0; i < perf_event_count; i++) {
+    _totals[phase][i].fetch_add(end.values[i] - begin.values[i], std::memory_order_relaxed);
+  }
+}
+
+} // minimacore
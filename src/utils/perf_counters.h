@@ -0,0 +1,130 @@
+
+#ifndef MINIMACORE_PERF_COUNTERS_H
+#define MINIMACORE_PERF_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace minimacore {
+
+enum class perf_event : std::uint8_t {
+  CYCLES = 0,
+  INSTRUCTIONS,
+  CACHE_MISSES,
+  BRANCH_MISSES,
+  TASK_CLOCK, // nanoseconds on the CPU, a software event available even without a hardware PMU
+};
+
+inline constexpr size_t perf_event_count = 5;
+
+struct perf_sample {
+  std::array<double, perf_event_count> values{};
+
+  double& operator[](perf_event event)
+  {
+    return values[size_t(event)];
+  }
+
+  double operator[](perf_event event) const
+  {
+    return values[size_t(event)];
+  }
+};
+
+/**
+ * @brief Counters of the calling thread, opened with perf_event_open as one group so they are scheduled together. Each
+ * event that cannot be opened (no PMU in a virtual machine, perf_event_paranoid, non-Linux system) is left out and
+ * reported as unavailable; if none can be opened the group is closed. Values are scaled when the kernel multiplexes
+ * the counters.
+ */
+class perf_counter_group {
+public:
+  [[nodiscard]] bool is_open() const
+  {
+    return _leader >= 0;
+  }
+
+  [[nodiscard]] bool available(perf_event event) const
+  {
+    return _fds[size_t(event)] >= 0;
+  }
+
+  /**
+   * @brief Reads the current counts, unavailable events read as 0.
+   */
+  bool read(perf_sample& sample) const;
+
+  static const char* name(perf_event event);
+
+  perf_counter_group();
+
+  perf_counter_group(const perf_counter_group&) = delete;
+
+  perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+  ~perf_counter_group();
+
+private:
+  int _leader{-1};
+  std::array<int, perf_event_count> _fds;
+  // Position of each open event in the group read
+  std::array<size_t, perf_event_count> _positions{};
+  size_t _open_count{0};
+};
+
+/**
+ * @brief Counter totals of a set of phases, accumulated over every thread that measures them. Each thread measures
+ * with its own counter group, opened on its first measurement.
+ */
+class perf_phase_counters {
+public:
+  /**
+   * @brief Adds the counts of the calling thread between construction and destruction to a phase. Does nothing if
+   * constructed without counters.
+   */
+  class scope {
+  public:
+    scope(perf_phase_counters* counters, size_t phase);
+
+    scope(const scope&) = delete;
+
+    scope& operator=(const scope&) = delete;
+
+    ~scope();
+
+  private:
+    perf_phase_counters* _counters;
+    size_t _phase;
+    perf_sample _begin;
+  };
+
+  /**
+   * @brief Opens the counters of the calling thread.
+   * @return false if no counter is available
+   */
+  bool open();
+
+  [[nodiscard]] bool available(perf_event event) const
+  {
+    return _available[size_t(event)];
+  }
+
+  /**
+   * @brief Totals of a phase since the last take, which resets them.
+   */
+  perf_sample take(size_t phase);
+
+  explicit perf_phase_counters(size_t phase_count);
+
+private:
+  void add(size_t phase, const perf_sample& begin, const perf_sample& end);
+
+  std::array<bool, perf_event_count> _available{};
+  std::vector<std::array<std::atomic<double>, perf_event_count>> _totals;
+};
+
+} // minimacore
+
+#endif //MINIMACORE_PERF_COUNTERS_H
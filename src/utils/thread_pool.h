@@ -13,6 +13,8 @@
 #include <condition_variable>
 #include <type_traits>
 #include <cstddef>
+#include <string>
+#include "tracer.h"
 
 namespace minimacore {
 
@@ -25,6 +27,11 @@ using std::mutex;
 using std::unique_lock;
 using std::condition_variable;
 
+/**
+ * @brief Fixed set of worker threads. Tasks are queued in lanes and the workers take them from the non-empty lanes in
+ * turn, so a client queueing many tasks at once (e.g. one runner of a sweep) does not starve the clients sharing the
+ * pool. Lane 0 is always open and used by enqueue.
+ */
 class thread_pool {
 
 public:
@@ -36,43 +43,90 @@ public:
   ~thread_pool();
   void stop();
 
+  [[nodiscard]] size_t thread_count() const
+  {
+    return _threads.size();
+  }
+
+  /**
+   * @brief Opens a lane for a client of the pool, reusing a closed one if any.
+   */
+  size_t open_lane();
+
+  /**
+   * @brief Closes a lane, the tasks already queued in it still run.
+   */
+  void close_lane(size_t lane);
+
   template<typename F, typename ... Args>
   std::future<typename std::invoke_result_t<F, Args...>> enqueue(F&& func, Args&& ... args)
   {
-    using return_t = typename std::invoke_result_t<F, Args...>;
-    auto task = std::make_shared<std::packaged_task<return_t()>>(
-            std::bind(std::forward<F>(func), std::forward<Args>(args)...));
-    std::future<return_t> res = task->get_future();
+    return enqueue_on(0, std::forward<F>(func), std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Runs the next queued task, of any lane, on the calling thread.
+   * @return false if no task was queued
+   */
+  bool run_pending_task();
+
+  /**
+   * @brief Queues a task without result in a lane.
+   */
+  void post(size_t lane, function<void()>&& task)
+  {
     {
       unique_lock<mutex> lock(_queue_mutex);
-      _queue.emplace([task]() { (*task)(); });
+      _lanes[lane].emplace(std::move(task));
+      _pending++;
     }
     _cond_var.notify_one();
+  }
+
+  template<typename F, typename ... Args>
+  std::future<typename std::invoke_result_t<F, Args...>> enqueue_on(size_t lane, F&& func, Args&& ... args)
+  {
+    using return_t = typename std::invoke_result_t<F, Args...>;
+    auto task = std::make_shared<std::packaged_task<return_t()>>(
+            std::bind(std::forward<F>(func), std::forward<Args>(args)...));
+    std::future<return_t> res = task->get_future();
+    post(lane, [task]() { (*task)(); });
     return res;
   }
 
 private:
-  queue<function<void()>> _queue{};
+  /*
+   * Takes the next task in round-robin order over the lanes, the caller holds the queue lock and a task is pending.
+   */
+  function<void()> take_task();
+
+  vector<queue<function<void()>>> _lanes{1};
+  vector<size_t> _closed_lanes;
+  size_t _next_lane{0};
+  size_t _pending{0};
   mutex _queue_mutex;
   vector<thread> _threads;
   atomic_bool _stop{false};
   condition_variable _cond_var;
 };
 
-thread_pool::thread_pool(size_t n)
+inline thread_pool::thread_pool(size_t n)
 {
   for (size_t i = 0; i < n; i++) {
     _threads.emplace_back(
-            [this] {
+            [this, i] {
+              if (tracer::enabled()) {
+                tracer::set_thread_name("worker " + std::to_string(i));
+              }
               while (true) {
                 function < void() > task;
                 {
                   unique_lock<mutex> lock(_queue_mutex);
-                  _cond_var.wait(lock, [this] { return _stop || !_queue.empty(); });
-                  if (_stop && _queue.empty()) return;
-                  task = std::move(_queue.front());
-                  _queue.pop();
+                  _cond_var.wait(lock, [this] { return _stop || _pending > 0; });
+                  if (_stop && _pending == 0) return;
+                  task = take_task();
                 }
+                MINIMACORE_TRACE_SCOPE("task", "thread_pool");
                 task();
               }
             }
@@ -80,12 +134,60 @@ thread_pool::thread_pool(size_t n)
   }
 }
 
-void thread_pool::stop() {
+inline size_t thread_pool::open_lane()
+{
+  unique_lock<mutex> lock(_queue_mutex);
+  if (!_closed_lanes.empty()) {
+    const size_t lane = _closed_lanes.back();
+    _closed_lanes.pop_back();
+    return lane;
+  }
+  _lanes.emplace_back();
+  return _lanes.size() - 1;
+}
+
+inline void thread_pool::close_lane(size_t lane)
+{
+  if (lane == 0) {
+    return;
+  }
+  unique_lock<mutex> lock(_queue_mutex);
+  _closed_lanes.push_back(lane);
+}
+
+inline bool thread_pool::run_pending_task()
+{
+  function<void()> task;
+  {
+    unique_lock<mutex> lock(_queue_mutex);
+    if (_pending == 0) {
+      return false;
+    }
+    task = take_task();
+  }
+  MINIMACORE_TRACE_SCOPE("task", "thread_pool");
+  task();
+  return true;
+}
+
+inline function<void()> thread_pool::take_task()
+{
+  while (_lanes[_next_lane].empty()) {
+    _next_lane = (_next_lane + 1) % _lanes.size();
+  }
+  function<void()> task = std::move(_lanes[_next_lane].front());
+  _lanes[_next_lane].pop();
+  _next_lane = (_next_lane + 1) % _lanes.size();
+  _pending--;
+  return task;
+}
+
+inline void thread_pool::stop() {
   _stop = true;
   _cond_var.notify_all();
 }
 
-thread_pool::~thread_pool()
+inline thread_pool::~thread_pool()
 {
   stop();
   for (auto& t : _threads) if (t.joinable()) t.join();
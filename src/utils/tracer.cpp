@@ -0,0 +1,159 @@
+
+#include "tracer.h"
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace minimacore {
+
+namespace {
+
+struct trace_event {
+  const char* name;
+  const char* category;
+  tracer::clock_t::time_point begin;
+  tracer::clock_t::duration duration;
+};
+
+/*
+ * Events of one thread. The mutex is only contended while exporting or clearing.
+ */
+struct thread_buffer {
+  std::mutex mutex;
+  size_t id{0};
+  std::string name;
+  std::vector<trace_event> events;
+};
+
+class trace_registry {
+public:
+  static trace_registry& instance()
+  {
+    static trace_registry registry;
+    return registry;
+  }
+
+  std::shared_ptr<thread_buffer> create()
+  {
+    auto buffer = std::make_shared<thread_buffer>();
+    std::lock_guard lock(_mutex);
+    buffer->id = _buffers.size() + 1;
+    _buffers.push_back(buffer);
+    return buffer;
+  }
+
+  template<typename Function_T>
+  void for_each(Function_T&& f)
+  {
+    std::lock_guard lock(_mutex);
+    for (auto& buffer : _buffers) {
+      std::lock_guard buffer_lock(buffer->mutex);
+      f(*buffer);
+    }
+  }
+
+  [[nodiscard]] tracer::clock_t::time_point epoch() const
+  {
+    return _epoch;
+  }
+
+private:
+  trace_registry() = default;
+
+  std::mutex _mutex;
+  std::vector<std::shared_ptr<thread_buffer>> _buffers;
+  tracer::clock_t::time_point _epoch{tracer::clock_t::now()};
+};
+
+thread_buffer& local_buffer()
+{
+  // Shared with the registry, so the events outlive the thread
+  thread_local std::shared_ptr<thread_buffer> buffer = trace_registry::instance().create();
+  return *buffer;
+}
+
+void write_string(std::ostream& stream, std::string_view text)
+{
+  stream << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      stream << '\\';
+    }
+    stream << c;
+  }
+  stream << '"';
+}
+
+double to_microseconds(tracer::clock_t::duration duration)
+{
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}
+
+void tracer::record(const char* name, const char* category, clock_t::time_point begin, clock_t::time_point end)
+{
+  thread_buffer& buffer = local_buffer();
+  std::lock_guard lock(buffer.mutex);
+  buffer.events.push_back({name, category, begin, end - begin});
+}
+
+void tracer::set_thread_name(const std::string& name)
+{
+  thread_buffer& buffer = local_buffer();
+  std::lock_guard lock(buffer.mutex);
+  buffer.name = name;
+}
+
+size_t tracer::event_count()
+{
+  size_t count = 0;
+  trace_registry::instance().for_each([&count](thread_buffer& buffer) { count += buffer.events.size(); });
+  return count;
+}
+
+void tracer::clear()
+{
+  trace_registry::instance().for_each([](thread_buffer& buffer) { buffer.events.clear(); });
+}
+
+bool tracer::export_chrome_trace(const std::string& path)
+{
+  std::ofstream stream(path, std::ios::out | std::ios::trunc);
+  if (!stream.is_open()) {
+    return false;
+  }
+  const clock_t::time_point epoch = trace_registry::instance().epoch();
+  bool first = true;
+  auto separator = [&stream, &first]() {
+    stream << (first ? "\n" : ",\n");
+    first = false;
+  };
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  stream.precision(3);
+  stream << std::fixed;
+  trace_registry::instance().for_each([&](thread_buffer& buffer) {
+    if (!buffer.name.empty()) {
+      separator();
+      stream << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer.id << R"(,"args":{"name":)";
+      write_string(stream, buffer.name);
+      stream << "}}";
+    }
+    for (const trace_event& event : buffer.events) {
+      separator();
+      stream << "{\"name\":";
+      write_string(stream, event.name);
+      stream << ",\"cat\":";
+      write_string(stream, event.category);
+      stream << R"(,"ph":"X","pid":1,"tid":)" << buffer.id << ",\"ts\":" << to_microseconds(event.begin - epoch)
+             << ",\"dur\":" << to_microseconds(event.duration) << '}';
+    }
+  });
+  stream << "\n]}\n";
+  return stream.good();
+}
+
+} // minimacore
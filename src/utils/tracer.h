@@ -0,0 +1,120 @@
+
+#ifndef MINIMACORE_TRACER_H
+#define MINIMACORE_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+ * Tracing is compiled in unless MINIMACORE_TRACING is defined to 0, in which case the MINIMACORE_TRACE_* macros expand
+ * to nothing. When compiled in, tracing still has to be enabled at run time with tracer::enable().
+ */
+#ifndef MINIMACORE_TRACING
+  #define MINIMACORE_TRACING 1
+#endif
+
+namespace minimacore {
+
+/**
+ * @brief Timeline recorder exported in the Chrome trace event format, which Perfetto (ui.perfetto.dev) and
+ * chrome://tracing open.
+ *
+ * Every thread records into its own buffer, so tracing threads do not contend with each other; the buffers outlive
+ * their threads and are merged on export. While tracing is disabled a scope costs one relaxed atomic load.
+ * Event names and categories must be string literals (or otherwise outlive the tracer).
+ */
+class tracer {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  static void enable()
+  {
+    _enabled.store(true, std::memory_order_relaxed);
+  }
+
+  static void disable()
+  {
+    _enabled.store(false, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static bool enabled()
+  {
+    return _enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Records a complete event of the calling thread.
+   */
+  static void record(const char* name, const char* category, clock_t::time_point begin, clock_t::time_point end);
+
+  /**
+   * @brief Names the calling thread in the exported timeline.
+   */
+  static void set_thread_name(const std::string& name);
+
+  /**
+   * @brief Number of events recorded over every thread.
+   */
+  static size_t event_count();
+
+  /**
+   * @brief Discards the recorded events.
+   */
+  static void clear();
+
+  /**
+   * @brief Writes the recorded events as Chrome trace JSON. Events recorded while exporting may be left out.
+   * @return false if the file could not be written
+   */
+  static bool export_chrome_trace(const std::string& path);
+
+private:
+  static inline std::atomic<bool> _enabled{false};
+};
+
+/**
+ * @brief Records the lifetime of the scope as one event when tracing is enabled at construction.
+ */
+class trace_scope {
+public:
+  trace_scope(const char* name, const char* category) : _name(name), _category(category)
+  {
+    if (tracer::enabled()) [[unlikely]] {
+      _begin = tracer::clock_t::now();
+      _active = true;
+    }
+  }
+
+  trace_scope(const trace_scope&) = delete;
+
+  trace_scope& operator=(const trace_scope&) = delete;
+
+  ~trace_scope()
+  {
+    if (_active) [[unlikely]] {
+      tracer::record(_name, _category, _begin, tracer::clock_t::now());
+    }
+  }
+
+private:
+  const char* _name;
+  const char* _category;
+  tracer::clock_t::time_point _begin;
+  bool _active{false};
+};
+
+} // minimacore
+
+#define MINIMACORE_TRACE_CONCAT_IMPL(a, b) a##b
+#define MINIMACORE_TRACE_CONCAT(a, b) MINIMACORE_TRACE_CONCAT_IMPL(a, b)
+
+#if MINIMACORE_TRACING
+  #define MINIMACORE_TRACE_SCOPE(name, category) \
+    ::minimacore::trace_scope MINIMACORE_TRACE_CONCAT(_minimacore_trace_, __LINE__)(name, category)
+#else
+  #define MINIMACORE_TRACE_SCOPE(name, category)
+#endif
+
+#endif //MINIMACORE_TRACER_H
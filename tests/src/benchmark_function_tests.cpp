@@ -19,11 +19,11 @@ TYPED_TEST(benchmark_functions_test, rastrigin3) {
 }
 
 TYPED_TEST(benchmark_functions_test, sphere2) {
-  ASSERT_NEAR(sphere<TypeParam>(Eigen::Vector<TypeParam, 2>({0., 0.})), 0., 1E-8);
+  ASSERT_NEAR(sphere(Eigen::Vector<TypeParam, 2>({0., 0.})), 0., 1E-8);
 }
 
 TYPED_TEST(benchmark_functions_test, sphere3) {
-  ASSERT_NEAR(sphere<TypeParam>(Eigen::Vector<TypeParam, 3>({0., 0., 0.})), 0., 1E-8);
+  ASSERT_NEAR(sphere(Eigen::Vector<TypeParam, 3>({0., 0., 0.})), 0., 1E-8);
 }
 
 TYPED_TEST(benchmark_functions_test, rosenbrock3) {
@@ -1,18 +1,25 @@
 
 #include "test_functions.h"
 
+#include <async_callbacks.h>
 #include <atomic>
+#include <dataset_evaluation.h>
+#include <filesystem>
 #include <future>
 #include <gtest/gtest.h>
 #include <ranges>
+#include <mapped_population.h>
+#include <population_recorder.h>
 #include <runner.h>
+#include <sweep.h>
 #include <utility>
 
 using namespace minimacore::genetic_algorithm;
 
-template <floating_point_type Fp_T> class chromosome_generator_impl : public base_chromosome_generator<Fp_T> {
+template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+class chromosome_generator_impl : public base_chromosome_generator<Fp_T, Dim_V> {
 public:
-  void generate_chromosome(const individual_ptr<Fp_T> &individual) const override {
+  void generate_chromosome(const individual_ptr<Fp_T, Dim_V> &individual) const override {
     std::random_device device;
     std::mt19937_64 generator(device());
     std::uniform_real_distribution<Fp_T> dist(_lower_limit, _upper_limit);
@@ -183,6 +190,61 @@ TYPED_TEST(minimacore_genetic_algorithm_tests, tournament_selection_for_reproduc
   }
 }
 
+TYPED_TEST(minimacore_genetic_algorithm_tests, tournament_selection_for_reproduction_parallel) {
+  population_t<TypeParam> population;
+  for (size_t i = 0; i < 1000; i++) {
+    auto &individual = population.emplace_back(std::make_shared<base_individual<TypeParam>>(genome_t<TypeParam>(), 1));
+    individual->set_objective_fitness(0, TypeParam(i));
+  }
+  tournament_selection_for_reproduction<TypeParam> selection(8, 500, 4);
+  vector selected_individuals = selection(population);
+  ASSERT_EQ(selected_individuals.size(), 500);
+  std::ranges::sort(selected_individuals);
+  EXPECT_EQ(std::ranges::adjacent_find(selected_individuals), selected_individuals.end());
+  // The worst individual can only win a tournament it contests alone
+  EXPECT_EQ(std::ranges::find(selected_individuals, population.back()), selected_individuals.end());
+}
+
+template <floating_point_type Fp_T> static population_t<Fp_T> linear_fitness_population(size_t size) {
+  population_t<Fp_T> population;
+  for (size_t i = 0; i < size; i++) {
+    auto &individual = population.emplace_back(std::make_shared<base_individual<Fp_T>>(genome_t<Fp_T>(), 1));
+    individual->set_objective_fitness(0, Fp_T(i));
+  }
+  return population;
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, roulette_wheel_selection_for_reproduction) {
+  auto population = linear_fitness_population<TypeParam>(1000);
+  population[10]->set_objective_fitness(0, std::numeric_limits<TypeParam>::quiet_NaN());
+  roulette_wheel_selection_for_reproduction<TypeParam> selection(5000);
+  vector selected_individuals = selection(population);
+  ASSERT_EQ(selected_individuals.size(), 5000);
+  EXPECT_EQ(std::ranges::find(selected_individuals, population[10]), selected_individuals.end());
+  // Weights decrease linearly with the fitness, the expected mean fitness is a third of the range
+  TypeParam mean = 0;
+  std::ranges::for_each(selected_individuals, [&mean](const auto &i) { mean += i->overall_fitness(); });
+  mean /= TypeParam(selected_individuals.size());
+  EXPECT_NEAR(mean, 333., 25.);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, stochastic_universal_sampling_for_reproduction) {
+  auto population = linear_fitness_population<TypeParam>(1000);
+  stochastic_universal_sampling_for_reproduction<TypeParam> selection(2000, 0.);
+  vector selected_individuals = selection(population);
+  ASSERT_EQ(selected_individuals.size(), 2000);
+  // Without selection pressure every individual gets its expected count of two, up to one pointer
+  for (const auto &individual : population) {
+    const auto count = std::ranges::count(selected_individuals, individual);
+    EXPECT_GE(count, 1);
+    EXPECT_LE(count, 3);
+  }
+  stochastic_universal_sampling_for_reproduction<TypeParam> pressured_selection(2000, 2.);
+  selected_individuals = pressured_selection(population);
+  EXPECT_GE(std::ranges::count(selected_individuals, population.front()), 5);
+  EXPECT_LE(std::ranges::count(selected_individuals, population.back()), 1);
+}
+
 TYPED_TEST(minimacore_genetic_algorithm_tests, ranked_selection_for_reproduction_by_ranks) {
   this->test_ranked_selection_for_reproduction_by_ranks(1);
   this->test_ranked_selection_for_reproduction_by_ranks(2);
@@ -364,6 +426,266 @@ TYPED_TEST(minimacore_genetic_algorithm_tests, uniform_mutation) {
   }
 }
 
+TYPED_TEST(minimacore_genetic_algorithm_tests, sparse_mutation) {
+  constexpr long genes = 100'000;
+  base_individual<TypeParam> individual(genome_t<TypeParam>::Zero(genes), 1);
+  sparse_gaussian_mutation<TypeParam> mutation(1., 1E-3, 1.);
+  genome_delta<TypeParam> delta;
+  ASSERT_TRUE(mutation.sample_delta(individual, delta));
+  EXPECT_GT(delta.size(), 50);
+  EXPECT_LT(delta.size(), 160);
+  EXPECT_TRUE(std::ranges::is_sorted(delta.indices));
+  EXPECT_EQ(std::ranges::adjacent_find(delta.indices), delta.indices.end());
+  EXPECT_LT(delta.indices.back(), genes);
+
+  genome_t<TypeParam> genome = individual.genome();
+  delta.apply_to(genome);
+  EXPECT_EQ((genome.array() != 0).count(), delta.size());
+
+  const long changed = (mutation(individual).array() != 0).count();
+  EXPECT_GT(changed, 50);
+  EXPECT_LT(changed, 160);
+
+  genome_batch_t<TypeParam> parents = genome_batch_t<TypeParam>::Zero(genes, 3);
+  genome_batch_t<TypeParam> offspring(genes, 3);
+  sparse_uniform_mutation<TypeParam>(1., 1E-3, 1.).apply_batch(parents, offspring);
+  for (Eigen::Index i = 0; i < offspring.cols(); i++) {
+    EXPECT_GT((offspring.col(i).array() != 0).count(), 50);
+    EXPECT_LT((offspring.col(i).array() != 0).count(), 160);
+  }
+
+  EXPECT_EQ((sparse_uniform_mutation<TypeParam>(1., 0., 1.)(individual).array() != 0).count(), 0);
+  EXPECT_EQ((sparse_uniform_mutation<TypeParam>(1., 1., 1.)(individual).array() != 0).count(), genes);
+  EXPECT_FALSE(gaussian_mutation<TypeParam>(1., 1.).sample_delta(individual, delta));
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, copy_on_write_genome) {
+  auto root = std::make_shared<base_individual<TypeParam>>(genome_t<TypeParam>::Zero(100), 1);
+  genome_delta<TypeParam> delta{{5, 10}, {1., 2.}};
+  auto child = std::make_shared<base_individual<TypeParam>>(genome_t<TypeParam>(), 1);
+  child->derive(root, delta);
+  ASSERT_TRUE(child->is_lazy());
+  EXPECT_EQ(child->root(), root);
+  EXPECT_EQ(child->genome_size(), 100);
+  EXPECT_EQ(child->gene(5), 1.);
+  EXPECT_EQ(child->gene(6), 0.);
+
+  // A lazy parent is skipped, the grandchild refers to the root with both deltas merged
+  base_individual<TypeParam> grandchild(genome_t<TypeParam>(), 1);
+  grandchild.derive(child, genome_delta<TypeParam>{{1, 10, 20}, {4., 3., 5.}});
+  ASSERT_TRUE(grandchild.is_lazy());
+  EXPECT_EQ(grandchild.root(), root);
+  EXPECT_EQ(grandchild.delta().indices, (vector<Eigen::Index>{1, 5, 10, 20}));
+  EXPECT_EQ(grandchild.delta().values, (vector<TypeParam>{4., 1., 3., 5.}));
+  EXPECT_TRUE(child->is_lazy());
+
+  const auto &dense = std::as_const(grandchild).genome();
+  EXPECT_FALSE(grandchild.is_lazy());
+  EXPECT_EQ(dense.sum(), 13.);
+  EXPECT_EQ(root->genome().sum(), 0.);
+
+  // Large deltas are compacted into a dense genome right away
+  genome_delta<TypeParam> large;
+  for (Eigen::Index i = 0; i < 50; i++) {
+    large.indices.push_back(i);
+    large.values.push_back(1.);
+  }
+  base_individual<TypeParam> compacted(genome_t<TypeParam>(), 1);
+  compacted.derive(root, large);
+  EXPECT_FALSE(compacted.is_lazy());
+  EXPECT_EQ(compacted.genome().sum(), 50.);
+
+  base_individual<TypeParam> copy(*child);
+  EXPECT_FALSE(copy.is_lazy());
+  EXPECT_EQ(copy.genome().sum(), 3.);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, mapped_population) {
+  const std::string path = "mapped_population_" + std::to_string(sizeof(TypeParam)) + ".bin";
+  {
+    mapped_population<TypeParam> population(path, 3, 2, 2);
+    ASSERT_TRUE(population.is_open());
+    ASSERT_TRUE(population.append(this->_population));
+    EXPECT_EQ(population.size(), this->_population.size());
+    EXPECT_GE(population.capacity(), population.size());
+    for (size_t i = 0; i < population.size(); i++) {
+      EXPECT_EQ(population.genome(i), this->_population[i]->genome());
+      EXPECT_EQ(population.fitness(i, 1).col(0), this->_population[i]->get_object_fitnesses());
+    }
+    population.flush();
+  }
+
+  mapped_population<TypeParam> population(path);
+  ASSERT_TRUE(population.is_open());
+  ASSERT_EQ(population.size(), this->_population.size());
+  EXPECT_EQ(population.genome_size(), 3);
+  EXPECT_EQ(population.objective_count(), 2);
+
+  size_t streamed = 0;
+  population.for_each_chunk(3, [&streamed](size_t first, auto &genomes, auto &fitness) {
+    EXPECT_EQ(first, streamed);
+    EXPECT_EQ(genomes.cols(), fitness.cols());
+    streamed += size_t(genomes.cols());
+  });
+  EXPECT_EQ(streamed, population.size());
+
+  population.evaluate(
+      [](base_individual<TypeParam> &individual) {
+        individual.set_objective_fitness(0, individual.genome().squaredNorm());
+        individual.set_objective_fitness(1, 0.);
+      },
+      4);
+  const Eigen::VectorX<TypeParam> fitness = population.fitness_index();
+  for (size_t i = 0; i < population.size(); i++) {
+    EXPECT_NEAR(fitness(long(i)), this->_population[i]->genome().squaredNorm(), 1E-4);
+  }
+  const vector<size_t> best = population.best(3);
+  ASSERT_EQ(best.size(), 3);
+  EXPECT_TRUE(std::ranges::is_sorted(best, {}, [&fitness](size_t i) { return fitness(long(i)); }));
+  EXPECT_EQ(fitness(long(best.front())), fitness.minCoeff());
+  EXPECT_EQ(population.load(best.front())->genome(), population.genome(best.front()));
+
+  // Growing the file moves the genome block
+  const size_t size = population.size();
+  ASSERT_TRUE(population.push_back(*population.load(0)));
+  EXPECT_GT(population.capacity(), size);
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_EQ(population.genome(i), this->_population[i]->genome());
+  }
+  EXPECT_EQ(population.genome(size), population.genome(0));
+  population.flush();
+  ASSERT_TRUE(mapped_population<TypeParam>(path).is_open());
+
+  // A truncated file is refused rather than read past its end
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+  EXPECT_FALSE(mapped_population<TypeParam>(path).is_open());
+  EXPECT_FALSE((mapped_population<TypeParam, 4>(path).is_open()));
+  std::remove(path.c_str());
+
+  // Opening a missing file does not create it
+  EXPECT_FALSE(mapped_population<TypeParam>(path).is_open());
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, population_recorder) {
+  const std::string path = "population_recorder_" + std::to_string(sizeof(TypeParam)) + ".bin";
+  const size_t count = this->_population.size();
+  {
+    population_recorder<TypeParam> recorder(path, 3, 2);
+    ASSERT_TRUE(recorder.is_open());
+    recorder.record(this->_population);
+    recorder.record(this->_population, 7);
+    recorder.flush();
+    EXPECT_EQ(recorder.recorded(), 2);
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  ASSERT_TRUE(file.is_open());
+  char magic[8];
+  std::uint32_t header[2];
+  std::uint64_t sizes[2];
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(header), sizeof(header));
+  file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+  EXPECT_EQ(std::string(magic, sizeof(magic)), "MMCREC01");
+  EXPECT_EQ(header[0], sizeof(TypeParam));
+  EXPECT_EQ(sizes[0], 3);
+  EXPECT_EQ(sizes[1], 2);
+  file.seekg(64);
+  for (std::uint64_t expected_generation : {0, 7}) {
+    std::uint64_t block[2];
+    file.read(reinterpret_cast<char *>(block), sizeof(block));
+    EXPECT_EQ(block[0], expected_generation);
+    ASSERT_EQ(block[1], count);
+    vector<TypeParam> columns(count * 5);
+    file.read(reinterpret_cast<char *>(columns.data()), std::streamsize(columns.size() * sizeof(TypeParam)));
+    for (size_t i = 0; i < count; i++) {
+      for (Eigen::Index gene = 0; gene < 3; gene++) {
+        EXPECT_EQ(columns[size_t(gene) * count + i], this->_population[i]->genome()(gene));
+      }
+      for (size_t objective = 0; objective < 2; objective++) {
+        EXPECT_EQ(columns[(3 + objective) * count + i], this->_population[i]->objective_fitness(objective));
+      }
+    }
+  }
+  EXPECT_EQ(file.peek(), std::char_traits<char>::eof());
+  file.close();
+  std::remove(path.c_str());
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, vectorized_generator) {
+  vectorized_generator<TypeParam> gen(7);
+  Eigen::ArrayX<TypeParam> samples(100'001);
+  gen.uniform(samples, -2., 4.);
+  EXPECT_GE(samples.minCoeff(), -2.);
+  EXPECT_LT(samples.maxCoeff(), 4.);
+  EXPECT_NEAR(samples.mean(), 1., 2E-2);
+  gen.normal(samples, 3., 2.);
+  const TypeParam mean = samples.mean();
+  EXPECT_NEAR(mean, 3., 2E-2);
+  EXPECT_NEAR(std::sqrt((samples - mean).square().mean()), 2., 2E-2);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, thread_generator) {
+  // The generator outlives its calls: a shorter fill reuses the scratch arrays of a longer one
+  using tag_t = minimacore_genetic_algorithm_tests<TypeParam>;
+  auto &gen = thread_generator<tag_t, TypeParam>(7);
+  EXPECT_EQ(&gen, (&thread_generator<tag_t, TypeParam>(0)));
+  Eigen::ArrayX<TypeParam> samples(10'001);
+  gen.normal(samples, 3., 2.);
+  Eigen::ArrayX<TypeParam> head(101);
+  gen.normal(head, 3., 2.);
+  EXPECT_TRUE(head.isFinite().all());
+  EXPECT_NEAR(head.mean(), 3., 1.);
+
+  // A seeded operator draws the same variates on every call
+  base_individual<TypeParam> parent(Eigen::VectorX<TypeParam>::Zero(vectorized_gene_threshold), 1);
+  const gaussian_mutation<TypeParam> mutation(1., .5, 11);
+  Eigen::VectorX<TypeParam> first;
+  Eigen::VectorX<TypeParam> second;
+  mutation.apply(parent, first);
+  mutation.apply(parent, second);
+  EXPECT_EQ(first, second);
+  const gaussian_mutation<TypeParam> unseeded(1., .5);
+  unseeded.apply(parent, first);
+  unseeded.apply(parent, second);
+  EXPECT_NE(first, second);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, batch_mutation) {
+  const genome_batch_t<TypeParam> parents = genome_batch_t<TypeParam>::Random(10'000, 4);
+  genome_batch_t<TypeParam> offspring(parents.rows(), parents.cols());
+  gaussian_mutation<TypeParam>(0.05, .5).apply_batch(parents, offspring);
+  const Eigen::ArrayX<TypeParam> noise = (offspring - parents).reshaped().array();
+  EXPECT_NEAR(noise.mean(), 0., 2E-2);
+  EXPECT_NEAR(std::sqrt(noise.square().mean()), .5, 2E-2);
+
+  uniform_mutation<TypeParam>(0.05, 3.).apply_batch(parents, offspring);
+  EXPECT_LE((offspring - parents).cwiseAbs().maxCoeff(), 3.);
+  EXPECT_GT((offspring - parents).cwiseAbs().maxCoeff(), 2.9);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, batch_crossover) {
+  const genome_batch_t<TypeParam> a = genome_batch_t<TypeParam>::Random(50, 8);
+  const genome_batch_t<TypeParam> b = genome_batch_t<TypeParam>::Random(50, 8);
+  const genome_batch_t<TypeParam> midpoint = (a + b) / 2;
+  const genome_batch_t<TypeParam> half_distance = ((b - a) / 2).cwiseAbs();
+  genome_batch_t<TypeParam> offspring(a.rows(), a.cols());
+
+  uniform_voluminal_crossover<TypeParam>(1.).apply_batch(a, b, offspring);
+  EXPECT_TRUE(((offspring - midpoint).cwiseAbs().array() <= half_distance.array() + 1E-5).all());
+
+  uniform_linear_crossover<TypeParam>(1.).apply_batch(a, b, offspring);
+  for (Eigen::Index i = 0; i < a.cols(); i++) {
+    // Every offspring lies on the segment joining its parents
+    const genome_t<TypeParam> direction = b.col(i) - a.col(i);
+    const genome_t<TypeParam> offset = offspring.col(i) - midpoint.col(i);
+    const TypeParam factor = offset.dot(direction) / direction.squaredNorm();
+    EXPECT_LE(std::abs(factor), .5 + 1E-5);
+    EXPECT_TRUE(offset.isApprox(factor * direction, 1E-3) || offset.norm() < 1E-5);
+  }
+}
+
 TYPED_TEST(minimacore_genetic_algorithm_tests, population_initialization) {
   auto &population = this->_population;
   auto &initial_genome = this->_genome_generator->initial_genome();
@@ -378,6 +700,25 @@ TYPED_TEST(minimacore_genetic_algorithm_tests, population_initialization) {
   }
 }
 
+TYPED_TEST(minimacore_genetic_algorithm_tests, individual_pool) {
+  individual_pool<TypeParam> pool;
+  auto individual = pool.acquire(3, 2);
+  const auto *address = individual.get();
+  individual->set_objective_fitness(0, 1.);
+  auto shared = individual;
+  pool.release(std::move(individual));
+  EXPECT_EQ(pool.available(), 0);
+  population_t<TypeParam> candidates{shared};
+  shared.reset();
+  pool.reclaim(candidates);
+  EXPECT_TRUE(candidates.empty());
+  ASSERT_EQ(pool.available(), 1);
+  auto recycled = pool.acquire(3, 2);
+  EXPECT_EQ(recycled.get(), address);
+  EXPECT_EQ(pool.available(), 0);
+  EXPECT_FALSE(recycled->is_valid());
+}
+
 template <floating_point_type Fp_T> class benchmark_function_evaluation : public base_evaluation<Fp_T> {
 public:
   size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
@@ -498,9 +839,10 @@ TYPED_TEST(minimacore_genetic_algorithm_tests, selection_pressure_termination_ne
   ASSERT_FALSE(termination(this->_statistics));
 }
 
-template <floating_point_type Fp_T> class sphere_evaluation_function : public base_evaluation<Fp_T> {
+template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+class sphere_evaluation_function : public base_evaluation<Fp_T, Dim_V> {
 public:
-  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+  size_t operator()(base_individual<Fp_T, Dim_V> &individual, size_t objective_index) const override {
     individual.set_objective_fitness(objective_index, std::abs(sphere(individual.genome())));
     return ++objective_index;
   }
@@ -533,6 +875,113 @@ TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run) {
   r.export_statistics("statistics.csv", ',');
 }
 
+template <floating_point_type Fp_T> static Fp_T evaluate_sphere(base_individual<Fp_T> &individual) {
+  individual.set_objective_fitness(0, sphere(individual.genome()));
+  return individual.overall_fitness();
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, coordinate_search) {
+  base_individual<TypeParam> individual(genome_t<TypeParam>::Constant(3, 1.), 1);
+  evaluate_sphere(individual);
+  coordinate_search<TypeParam> search(.5, 200);
+  const size_t evaluations = search(individual, &evaluate_sphere<TypeParam>);
+  EXPECT_LE(evaluations, 200);
+  EXPECT_LT(individual.overall_fitness(), 1E-3);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, nelder_mead) {
+  base_individual<TypeParam> individual(genome_t<TypeParam>::Constant(3, 1.), 1);
+  evaluate_sphere(individual);
+  const TypeParam initial_fitness = individual.overall_fitness();
+  nelder_mead<TypeParam> search(.5, 300);
+  const size_t evaluations = search(individual, &evaluate_sphere<TypeParam>);
+  EXPECT_LE(evaluations, 300);
+  EXPECT_LT(individual.overall_fitness(), initial_fitness * 1E-3);
+  EXPECT_NEAR(individual.overall_fitness(), sphere(individual.genome()), 1E-6);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_local_search) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s;
+  s.set_population_size(10)
+      .set_generations(5)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .set_local_search(std::make_unique<nelder_mead<TypeParam>>(.5, 100), 2, 2)
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  ASSERT_LT(r.get_best_individual()->overall_fitness(), 1E-2);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_fixed_dimension) {
+  constexpr int dimension = 3;
+  static_assert(genome_t<TypeParam, dimension>::SizeAtCompileTime == dimension);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam, dimension>>(genome_t<TypeParam, dimension>::Constant(5.));
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam, dimension>>(-5., 5.));
+  setup<TypeParam, dimension> s;
+  s.set_population_size(10)
+      .set_generations(20)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam, dimension>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam, dimension>>(6))
+      .set_crossover(std::make_unique<uniform_voluminal_crossover<TypeParam, dimension>>(1.))
+      .set_mutation(std::make_unique<gaussian_mutation<TypeParam, dimension>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam, dimension>>());
+  runner<TypeParam, dimension> r(std::move(s));
+  ASSERT_EQ(r.run(), (runner<TypeParam, dimension>::exit_flag::SUCCESS));
+  ASSERT_LT(r.get_best_individual()->overall_fitness(), r.get_individual_zero()->overall_fitness());
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_static_dispatch) {
+  constexpr int dimension = 3;
+  using static_setup_t =
+      static_setup<TypeParam, dimension, truncation_selection_for_reproduction<TypeParam, dimension>,
+                   truncation_selection_for_replacement<TypeParam, dimension>,
+                   uniform_linear_crossover<TypeParam, dimension>, uniform_mutation<TypeParam, dimension>,
+                   sphere_evaluation_function<TypeParam, dimension>>;
+  auto genome_gen = std::make_unique<genome_generator<TypeParam, dimension>>(genome_t<TypeParam, dimension>::Constant(5.));
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam, dimension>>(-5., 5.));
+  static_setup_t s;
+  s.set_selection_for_reproduction(4)
+      .set_selection_for_replacement(6)
+      .set_crossover(1.)
+      .set_mutation(.05, 1.)
+      .set_population_size(10)
+      .set_generations(20)
+      .set_genome_generator(std::move(genome_gen));
+  EXPECT_EQ(s.objective_count(), 1);
+  runner r(std::move(s));
+  static_assert(std::is_same_v<decltype(r), runner<TypeParam, dimension, static_setup_t>>);
+  ASSERT_EQ(r.run(), decltype(r)::exit_flag::SUCCESS);
+  ASSERT_LT(r.get_best_individual()->overall_fitness(), r.get_individual_zero()->overall_fitness());
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_sparse_mutation) {
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(Eigen::VectorX<TypeParam>::Constant(200, 5.));
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s;
+  s.set_population_size(20)
+      .set_generations(20)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(8))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(12))
+      .set_crossover(std::make_unique<uniform_voluminal_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<sparse_gaussian_mutation<TypeParam>>(.5, .01, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  ASSERT_LT(r.get_best_individual()->overall_fitness(), r.get_individual_zero()->overall_fitness());
+  for (const auto &individual : r.get_population()) {
+    EXPECT_NEAR(individual->overall_fitness(), sphere(individual->genome()), 1E-3 * individual->overall_fitness());
+  }
+}
+
 template <floating_point_type Fp_T> class basic_wait_function : public base_evaluation<Fp_T> {
 public:
   size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
@@ -705,3 +1154,1011 @@ TYPED_TEST(minimacore_genetic_algorithm_tests, iteration_callback_count) {
   ASSERT_EQ(callback_count, r.get_setup().generations());
 }
 
+TYPED_TEST(minimacore_genetic_algorithm_tests, async_callbacks_overflow) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  vector<size_t> generations;
+  async_callbacks<TypeParam> callbacks(2, overflow_policy::DROP_OLDEST);
+  callbacks.add([&released, &generations](const auto &snapshot) {
+    released.wait();
+    generations.push_back(snapshot.generation);
+  });
+  callbacks.publish(0, this->_population, this->_population.front());
+  while (callbacks.pending() > 0) {
+    std::this_thread::yield();
+  }
+  // The worker holds the first snapshot, two more fill the queue and the last two push out the oldest queued ones
+  for (size_t generation = 1; generation < 5; generation++) {
+    callbacks.publish(generation, this->_population, this->_population.front());
+  }
+  EXPECT_EQ(callbacks.pending(), 2);
+  release.set_value();
+  callbacks.drain();
+  EXPECT_EQ(callbacks.delivered(), 3);
+  EXPECT_EQ(callbacks.dropped(), 2);
+  EXPECT_EQ(generations, (vector<size_t>{0, 3, 4}));
+  for (auto &individual : this->_population) {
+    EXPECT_EQ(individual.use_count(), 1);
+  }
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, async_callbacks_run) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  size_t callback_count = 0;
+  size_t async_count = 0;
+  TypeParam best_fitness = std::numeric_limits<TypeParam>::max();
+  bool improving = true;
+  s.set_population_size(10)
+      .set_generations(20)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>())
+      .add_callback([&callback_count]() { ++callback_count; })
+      .set_async_callback_queue(4, overflow_policy::BLOCK)
+      .add_async_callback([&](const population_snapshot<TypeParam> &snapshot) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        async_count++;
+        EXPECT_EQ(snapshot.population.size(), 10);
+        improving &= snapshot.best->overall_fitness() <= best_fitness;
+        best_fitness = snapshot.best->overall_fitness();
+      });
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  // With backpressure every generation is observed, and the run only returns once they all were
+  EXPECT_EQ(async_count, callback_count);
+  EXPECT_EQ(r.get_setup().get_async_callbacks().dropped(), 0);
+  EXPECT_TRUE(improving);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, hardware_counters) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(10)
+      .set_generations(5)
+      .set_hardware_counters(true)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  const std::string path = "hardware_counters_" + std::to_string(sizeof(TypeParam)) + ".csv";
+  r.export_statistics(path, ',');
+
+  std::ifstream file(path);
+  std::string header;
+  std::getline(file, header);
+  const minimacore::perf_counter_group counters;
+  if (!counters.is_open()) {
+    // Without counters the run still succeeds and exports the usual statistics
+    EXPECT_EQ(header, "best_fitness,average_fitness,selection_pressure");
+  } else {
+    for (const char *phase : runner<TypeParam>::profiling_phase_names) {
+      for (size_t event = 0; event < minimacore::perf_event_count; event++) {
+        const auto name = std::string(phase) + '_' + minimacore::perf_counter_group::name(minimacore::perf_event(event));
+        EXPECT_EQ(header.find(name) != std::string::npos, counters.available(minimacore::perf_event(event))) << name;
+      }
+    }
+    std::string first_generation;
+    std::getline(file, first_generation);
+    EXPECT_EQ(std::ranges::count(first_generation, ','), std::ranges::count(header, ','));
+  }
+  file.close();
+  std::remove(path.c_str());
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, rbf_surrogate) {
+  using matrix_t = Eigen::Matrix<TypeParam, Eigen::Dynamic, Eigen::Dynamic>;
+  constexpr size_t window = 20;
+  const TypeParam width = 1.;
+  const TypeParam regularization = 1E-3;
+  rbf_surrogate<TypeParam> surrogate(width, window, regularization);
+  EXPECT_TRUE(std::isnan(surrogate.predict(genome_t<TypeParam>::Zero(2))));
+
+  std::mt19937_64 generator(3);
+  std::uniform_real_distribution<TypeParam> distribution(-2., 2.);
+  vector<genome_t<TypeParam>> samples;
+  for (size_t i = 0; i < 50; i++) {
+    auto &sample = samples.emplace_back(genome_t<TypeParam>(2));
+    sample << distribution(generator), distribution(generator);
+    surrogate.update(sample, sphere(sample));
+  }
+  ASSERT_EQ(surrogate.size(), window);
+
+  // The incrementally maintained model matches a refit on the last `window` samples
+  const auto first = samples.size() - window;
+  auto kernel = [&width](const genome_t<TypeParam> &a, const genome_t<TypeParam> &b) {
+    return std::exp(-(a - b).squaredNorm() / (2 * width * width));
+  };
+  matrix_t gram(window, window);
+  Eigen::VectorX<TypeParam> values(window);
+  for (size_t i = 0; i < window; i++) {
+    values(i) = sphere(samples[first + i]);
+    for (size_t j = 0; j < window; j++) {
+      gram(i, j) = kernel(samples[first + i], samples[first + j]) + (i == j ? regularization : 0);
+    }
+  }
+  const TypeParam mean = values.mean();
+  const Eigen::VectorX<TypeParam> weights = gram.llt().solve((values.array() - mean).matrix());
+  for (size_t trial = 0; trial < 10; trial++) {
+    genome_t<TypeParam> x(2);
+    x << distribution(generator), distribution(generator);
+    TypeParam expected = mean;
+    for (size_t i = 0; i < window; i++) {
+      expected += weights(i) * kernel(x, samples[first + i]);
+    }
+    EXPECT_NEAR(surrogate.predict(x), expected, 1E-2 * std::max<TypeParam>(1, std::abs(expected)));
+  }
+  // Near the samples the interpolant reproduces the fitness
+  EXPECT_NEAR(surrogate.predict(samples.back()), sphere(samples.back()), 1E-1);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_surrogate) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(20)
+      .set_generations(20)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(8))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(10))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .set_surrogate(std::make_unique<rbf_surrogate<TypeParam>>(2., 64, 1E-4), 4)
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  ASSERT_LT(r.get_best_individual()->overall_fitness(), r.get_individual_zero()->overall_fitness());
+  EXPECT_EQ(r.get_setup().surrogate()->size(), 64);
+
+  const std::string path = "surrogate_" + std::to_string(sizeof(TypeParam)) + ".csv";
+  r.export_statistics(path, ',');
+  std::ifstream file(path);
+  std::string header;
+  std::getline(file, header);
+  EXPECT_EQ(header, "best_fitness,average_fitness,selection_pressure,surrogate_error");
+  file.close();
+  std::remove(path.c_str());
+}
+
+/*
+ * Hangs until cancelled on the individuals whose first gene is negative
+ */
+template <floating_point_type Fp_T> class hanging_evaluation_function : public base_evaluation<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    individual.set_objective_fitness(objective_index, individual.genome().squaredNorm());
+    return ++objective_index;
+  }
+
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index,
+                    const minimacore::cancellation_token &token) const override {
+    while (individual.genome()(0) < 0 && !token.cancelled()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return (*this)(individual, objective_index);
+  }
+
+  [[nodiscard]] size_t objective_count() const override {
+    return 1;
+  }
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_evaluation_time_limit) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(10)
+      .set_generations(10)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.5, 5.))
+      .set_genome_generator(std::move(genome_gen))
+      .set_evaluation_time_limit(std::chrono::milliseconds(20))
+      .add_evaluation(std::make_unique<hanging_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  ASSERT_EQ(r.get_population().size(), 10);
+  for (const auto &individual : r.get_population()) {
+    EXPECT_GE(individual->genome()(0), 0.);
+  }
+  const auto &metrics = r.get_statistics().metric_names();
+  EXPECT_NE(std::ranges::find(metrics, "abandoned_evaluations"), metrics.end());
+}
+
+/*
+ * Takes 200 ms, ignoring its token, on the individuals whose first gene is negative
+ */
+template <floating_point_type Fp_T> class slow_evaluation_function : public base_evaluation<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    if (individual.genome()(0) < 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    individual.set_objective_fitness(objective_index, individual.genome().squaredNorm());
+    return ++objective_index;
+  }
+
+  [[nodiscard]] size_t objective_count() const override {
+    return 1;
+  }
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_time_limit_initialization_local_search) {
+  // Individual zero is slow, as are the local search trials crossing zero
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, -5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(0., 5.));
+  setup<TypeParam> s{};
+  s.set_thread_count(8);
+  s.set_population_size(10)
+      .set_generations(10)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .set_local_search(std::make_unique<nelder_mead<TypeParam>>(5., 20), 2, 2)
+      .set_evaluation_time_limit(std::chrono::milliseconds(20))
+      .add_evaluation(std::make_unique<slow_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  EXPECT_TRUE(std::isnan(r.get_individual_zero()->overall_fitness()));
+  ASSERT_EQ(r.get_population().size(), 10);
+  for (const auto &individual : r.get_population()) {
+    EXPECT_FALSE(std::isnan(individual->overall_fitness()));
+  }
+  // Waiting out individual zero and the refinements would take well over a second, while the runner only waits for
+  // their time limit (the abandoned evaluations still hold their threads meanwhile)
+  EXPECT_LT(r.elapsed_time_ms().count(), 600.);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, evaluation_budget_during_initialization) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_thread_count(2);
+  s.set_population_size(20)
+      .set_generations(10)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_termination(std::make_unique<evaluation_budget_termination<TypeParam>>(5))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  // The run ends cleanly with the individuals evaluated within the budget
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  EXPECT_GE(r.get_statistics().evaluation_count(), 5);
+  EXPECT_LE(r.get_statistics().evaluation_count(), 7);
+  EXPECT_FALSE(r.get_population().empty());
+  EXPECT_LT(r.get_population().size(), 20);
+  for (const auto &individual : r.get_population()) {
+    EXPECT_FALSE(std::isnan(individual->overall_fitness()));
+  }
+  EXPECT_EQ(r.get_statistics().current_generation(), 1);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, evaluation_budget_termination) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(10)
+      .set_generations(1000)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_termination(std::make_unique<evaluation_budget_termination<TypeParam>>(200))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  // Evaluations already started when the budget ran out may complete
+  EXPECT_GE(r.get_statistics().evaluation_count(), 200);
+  EXPECT_LE(r.get_statistics().evaluation_count(), 210);
+  EXPECT_LT(r.get_statistics().current_generation(), 1000);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, wall_clock_termination) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(10)
+      .set_generations(1000)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_termination(std::make_unique<wall_clock_termination<TypeParam>>(std::chrono::milliseconds(150)))
+      .add_evaluation(std::make_unique<basic_wait_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  EXPECT_LT(r.get_statistics().current_generation(), 1000);
+  // Pending evaluations are cancelled at the budget instead of completing the generation
+  EXPECT_LT(r.elapsed_time_ms().count(), 1000.);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, sweep_run) {
+  sweep<setup<TypeParam>> runs(4);
+  for (size_t population_size : {6, 8, 10, 12, 14, 16}) {
+    runs.add([population_size]() {
+      Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+      auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+      genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+      setup<TypeParam> s{};
+      s.set_population_size(population_size)
+          .set_generations(15)
+          .set_selection_for_reproduction(
+              std::make_unique<truncation_selection_for_reproduction<TypeParam>>(population_size / 2))
+          .set_selection_for_replacement(
+              std::make_unique<truncation_selection_for_replacement<TypeParam>>(population_size / 2))
+          .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+          .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+          .set_genome_generator(std::move(genome_gen))
+          .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+      return s;
+    });
+  }
+  const auto &results = runs.run();
+  ASSERT_EQ(results.size(), 6);
+  for (const auto &result : results) {
+    EXPECT_EQ(result.flag, runner<TypeParam>::exit_flag::SUCCESS);
+    ASSERT_NE(result.best_individual, nullptr);
+    EXPECT_LT(result.best_individual->overall_fitness(), 75.);
+    EXPECT_GT(result.evaluation_count, 0);
+    EXPECT_EQ(result.statistics.rows(), 15);
+    EXPECT_EQ(result.columns.front(), "best_fitness");
+  }
+
+  const std::string path = "sweep_" + std::to_string(sizeof(TypeParam)) + ".csv";
+  runs.export_statistics(path, ',');
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  EXPECT_EQ(line, "run,generation,best_fitness,average_fitness,selection_pressure");
+  size_t rows = 0;
+  while (std::getline(file, line)) {
+    rows++;
+  }
+  EXPECT_EQ(rows, 6 * 15);
+  file.close();
+  std::remove(path.c_str());
+}
+
+/*
+ * Counts the evaluations running as tasks of the expected executor
+ */
+template <floating_point_type Fp_T> class executor_probe_function : public sphere_evaluation_function<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    if (minimacore::base_executor::current() == _expected) {
+      (*_count)++;
+    }
+    return sphere_evaluation_function<Fp_T>::operator()(individual, objective_index);
+  }
+
+  executor_probe_function(const minimacore::base_executor *expected, std::atomic_size_t *count)
+      : _expected(expected), _count(count) {}
+
+private:
+  const minimacore::base_executor *_expected;
+  std::atomic_size_t *_count;
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_external_executor) {
+  // Stands for the executor of a host application
+  minimacore::thread_pool host(2);
+  std::atomic_size_t submitted{0};
+  std::atomic_size_t on_executor{0};
+  minimacore::external_executor executor(
+      [&host, &submitted](std::function<void()> &&task) {
+        submitted++;
+        host.post(0, std::move(task));
+      },
+      host.thread_count());
+
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(10)
+      .set_generations(10)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<executor_probe_function<TypeParam>>(&executor, &on_executor));
+  runner<TypeParam> r(std::move(s), executor);
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  // One task per evaluation, except individual zero evaluated by the runner thread itself
+  EXPECT_EQ(submitted.load(), r.get_statistics().evaluation_count() - 1);
+  EXPECT_EQ(on_executor.load(), submitted.load());
+}
+
+/*
+ * Fits the genome mean to a large dataset, the rows being reduced in parallel when the runner allows it
+ */
+template <floating_point_type Fp_T> class dataset_evaluation_function : public base_evaluation<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    const double mean = double(individual.genome().mean());
+    _max_width = std::max(_max_width.load(), minimacore::base_executor::nested_width());
+    const double error = minimacore::parallel_reduce(
+        _rows.size(), 0.,
+        [this, mean](size_t begin, size_t end) {
+          double sum = 0;
+          for (size_t i = begin; i < end; i++) {
+            sum += (_rows[i] - mean) * (_rows[i] - mean);
+          }
+          return sum;
+        },
+        std::plus<>{}, 4096);
+    individual.set_objective_fitness(objective_index, Fp_T(error / double(_rows.size())));
+    return ++objective_index;
+  }
+
+  [[nodiscard]] size_t objective_count() const override {
+    return 1;
+  }
+
+  [[nodiscard]] size_t max_width() const {
+    return _max_width;
+  }
+
+  explicit dataset_evaluation_function(size_t rows) : _rows(rows) {
+    for (size_t i = 0; i < rows; i++) {
+      _rows[i] = double(i % 7);
+    }
+  }
+
+private:
+  vector<double> _rows;
+  mutable std::atomic_size_t _max_width{1};
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_nested_parallelism) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  auto evaluation = std::make_unique<dataset_evaluation_function<TypeParam>>(1 << 20);
+  const auto *probe = evaluation.get();
+  setup<TypeParam> s{};
+  s.set_thread_count(8);
+  s.set_population_size(4)
+      .set_generations(5)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(2))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(2))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::move(evaluation));
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  // Eight workers: the initial four individuals may use two each, the batches of two offspring four each
+  EXPECT_EQ(probe->max_width(), 4);
+  const auto &best = *r.get_best_individual();
+  const double mean = double(best.genome().mean());
+  double expected = 0;
+  for (size_t i = 0; i < (1 << 20); i++) {
+    expected += (double(i % 7) - mean) * (double(i % 7) - mean);
+  }
+  EXPECT_NEAR(double(best.overall_fitness()), expected / double(1 << 20), 1E-3);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, mapped_dataset) {
+  const std::string path = "mapped_dataset_" + std::to_string(sizeof(TypeParam)) + ".bin";
+  Eigen::MatrixX<TypeParam> data(5, 2);
+  data << 1., 10., 2., 20., 3., 30., 4., 40., 5., 50.;
+  ASSERT_TRUE(mapped_dataset<TypeParam>::write(path, data));
+
+  mapped_dataset<TypeParam> dataset(path);
+  ASSERT_TRUE(dataset.is_open());
+  EXPECT_EQ(dataset.rows(), 5);
+  EXPECT_EQ(dataset.columns(), 2);
+  EXPECT_EQ(dataset.column(1), data.col(1));
+  EXPECT_EQ(dataset.block(1, 3), data.middleRows(1, 3));
+  dataset.prefetch(1, 3);
+
+  // Another scalar type is rejected
+  using other_t = std::conditional_t<std::is_same_v<TypeParam, float>, double, float>;
+  EXPECT_FALSE(mapped_dataset<other_t>(path).is_open());
+  EXPECT_FALSE(mapped_dataset<TypeParam>("missing_dataset.bin").is_open());
+}
+
+/*
+ * Squared error of the genome mean to the first column of the dataset
+ */
+template <floating_point_type Fp_T> class mean_dataset_evaluation : public dataset_evaluation<Fp_T> {
+public:
+  using typename dataset_evaluation<Fp_T>::rows_t;
+  using dataset_evaluation<Fp_T>::dataset_evaluation;
+
+protected:
+  Fp_T loss(const base_individual<Fp_T> &individual, const rows_t &rows) const override {
+    return (rows.col(0).array() - individual.genome().mean()).square().sum();
+  }
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_dataset_mini_batches) {
+  const std::string path = "dataset_evaluation_" + std::to_string(sizeof(TypeParam)) + ".bin";
+  const size_t rows = 1 << 14;
+  Eigen::MatrixX<TypeParam> data(rows, 1);
+  for (size_t i = 0; i < rows; i++) {
+    data(Eigen::Index(i), 0) = TypeParam(i % 7);
+  }
+  ASSERT_TRUE(mapped_dataset<TypeParam>::write(path, data));
+  auto dataset = std::make_shared<const mapped_dataset<TypeParam>>(path);
+  ASSERT_TRUE(dataset->is_open());
+
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  auto evaluation = std::make_unique<mean_dataset_evaluation<TypeParam>>(dataset);
+  evaluation->set_mini_batches(512, .5);
+  const auto *probe = evaluation.get();
+  setup<TypeParam> s{};
+  s.set_thread_count(4);
+  s.set_population_size(20)
+      .set_generations(10)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(10))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(10))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::move(evaluation));
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  EXPECT_GT(probe->promotions(), 0);
+  // The last generations are scored on the full dataset, so the best fitness is exact
+  const auto &best = *r.get_best_individual();
+  const double mean = double(best.genome().mean());
+  double expected = 0;
+  for (size_t i = 0; i < rows; i++) {
+    expected += (double(i % 7) - mean) * (double(i % 7) - mean);
+  }
+  EXPECT_NEAR(double(best.overall_fitness()), expected / double(rows), 1E-2);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, mapped_population_evolve) {
+  const std::string path = "mapped_evolution_" + std::to_string(sizeof(TypeParam)) + ".bin";
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s;
+  s.set_population_size(40)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(10))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(20))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+
+  mapped_population<TypeParam> population(path, 3, 1, 8);
+  ASSERT_TRUE(population.is_open());
+  for (size_t i = 0; i < s.population_size(); i++) {
+    auto individual = std::make_shared<base_individual<TypeParam>>(initial_genome, 1);
+    s.get_genome_generator()(individual);
+    ASSERT_TRUE(population.push_back(*individual));
+  }
+  population.evaluate([&s](base_individual<TypeParam> &individual) { (void) s.evaluate(individual); }, 16);
+  evolution_statistics<TypeParam> statistics(21);
+  population.register_statistic(statistics);
+  const TypeParam initial_best = population.fitness_index().minCoeff();
+
+  for (size_t generation = 0; generation < 20; generation++) {
+    // The 20 offspring of each generation are evaluated
+    EXPECT_EQ(population.evolve(s, statistics, 16), 20);
+    ASSERT_EQ(population.size(), s.population_size());
+  }
+  EXPECT_EQ(statistics.current_generation(), 21);
+  EXPECT_EQ(statistics.evaluation_count(), 400);
+  const size_t best = population.best(1).front();
+  EXPECT_LT(population.fitness_index()(long(best)), initial_best);
+  // Survivors are moved with their objectives
+  for (size_t i = 0; i < population.size(); i++) {
+    EXPECT_NEAR(population.fitness(i, 1)(0, 0), population.genome(i).squaredNorm(), 1E-3);
+  }
+  std::remove(path.c_str());
+}
+
+/*
+ * Sphere whose scores all get worse halfway through the run, as when a mini-batch evaluation switches to harder data
+ */
+template <floating_point_type Fp_T> class shifting_sphere_evaluation : public sphere_evaluation_function<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    individual.set_objective_fitness(objective_index, individual.genome().squaredNorm() + _offset);
+    return ++objective_index;
+  }
+
+  bool begin_generation(size_t generation, size_t generations) override {
+    return std::exchange(_offset, 2 * generation < generations ? Fp_T(0) : Fp_T(100)) != _offset;
+  }
+
+private:
+  Fp_T _offset{0};
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_rescores_survivors) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s{};
+  s.set_population_size(20)
+      .set_generations(10)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(10))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(10))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<shifting_sphere_evaluation<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  // Survivors scored before the shift would otherwise outrank every offspring
+  for (const auto &individual : r.get_population()) {
+    EXPECT_NEAR(individual->overall_fitness(), individual->genome().squaredNorm() + 100, 1E-3);
+  }
+}
+
+/*
+ * Sphere bounded below by zero, cheap enough to run first when pruning
+ */
+template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+class bounded_sphere_evaluation : public sphere_evaluation_function<Fp_T, Dim_V> {
+public:
+  [[nodiscard]] Fp_T lower_bound() const override {
+    return 0;
+  }
+};
+
+/*
+ * Costly evaluation bounded below by zero, refining the sphere by a small term and counting its calls
+ */
+template <floating_point_type Fp_T, int Dim_V = dynamic_dimension>
+class costly_evaluation_function : public base_evaluation<Fp_T, Dim_V> {
+public:
+  size_t operator()(base_individual<Fp_T, Dim_V> &individual, size_t objective_index) const override {
+    _calls++;
+    individual.set_objective_fitness(objective_index, Fp_T(1E-3) * individual.genome().cwiseAbs().sum());
+    return ++objective_index;
+  }
+
+  [[nodiscard]] size_t objective_count() const override {
+    return 1;
+  }
+
+  [[nodiscard]] Fp_T lower_bound() const override {
+    return 0;
+  }
+
+  [[nodiscard]] double relative_cost() const override {
+    return 100.;
+  }
+
+  [[nodiscard]] size_t calls() const {
+    return _calls;
+  }
+
+private:
+  mutable std::atomic_size_t _calls{0};
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, evaluation_pruning) {
+  auto costly = std::make_unique<costly_evaluation_function<TypeParam>>();
+  const auto *probe = costly.get();
+  setup<TypeParam> s;
+  s.set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(1))
+      .add_evaluation(std::move(costly))
+      .add_evaluation(std::make_unique<bounded_sphere_evaluation<TypeParam>>());
+  EXPECT_TRUE(s.replacement_keeps_best());
+
+  // The cheap sphere runs first, its objective keeps the index it was added with
+  base_individual<TypeParam> individual(genome_t<TypeParam>::Constant(3, 1.), 2);
+  EXPECT_EQ(s.evaluate(individual, {}, TypeParam(1.)), 1);
+  EXPECT_TRUE(individual.is_rejected());
+  EXPECT_EQ(probe->calls(), 0);
+  EXPECT_EQ(individual.objective_fitness(0), 0.);
+  EXPECT_EQ(individual.objective_fitness(1), 3.);
+
+  EXPECT_EQ(s.evaluate(individual, {}, TypeParam(10.)), 2);
+  EXPECT_FALSE(individual.is_rejected());
+  EXPECT_EQ(probe->calls(), 1);
+  EXPECT_NEAR(individual.overall_fitness(), 3.003, 1E-5);
+
+  using static_setup_t = static_setup<TypeParam, dynamic_dimension, truncation_selection_for_reproduction<TypeParam>,
+                                      truncation_selection_for_replacement<TypeParam>,
+                                      uniform_linear_crossover<TypeParam>, uniform_mutation<TypeParam>,
+                                      bounded_sphere_evaluation<TypeParam>, costly_evaluation_function<TypeParam>>;
+  static_setup_t static_s;
+  static_s.set_selection_for_replacement(1);
+  EXPECT_TRUE(static_s.replacement_keeps_best());
+  EXPECT_EQ(static_s.evaluate(individual, {}, TypeParam(1.)), 1);
+  EXPECT_TRUE(individual.is_rejected());
+  EXPECT_EQ(individual.objective_fitness(1), 0.);
+  EXPECT_EQ(static_s.evaluate(individual), 2);
+  EXPECT_FALSE(individual.is_rejected());
+  EXPECT_NEAR(individual.objective_fitness(1), .003, 1E-5);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_evaluation_pruning) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  auto costly = std::make_unique<costly_evaluation_function<TypeParam>>();
+  const auto *probe = costly.get();
+  setup<TypeParam> s;
+  s.set_population_size(20)
+      .set_generations(20)
+      .set_evaluation_pruning(true)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(8))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(10))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::move(costly))
+      .add_evaluation(std::make_unique<bounded_sphere_evaluation<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+
+  const auto &statistics = r.get_statistics();
+  double pruned = 0;
+  for (size_t generation = 0; generation < statistics.current_generation(); generation++) {
+    const double value = statistics.metric("pruned_evaluations", generation);
+    pruned += std::isnan(value) ? 0. : value;
+  }
+  EXPECT_GT(pruned, 0.);
+  // Each individual runs the sphere, and the costly evaluation unless pruned
+  EXPECT_EQ(probe->calls() * 2 + size_t(pruned), statistics.evaluation_count());
+  // Statistics leave out the bounded fitness of the rejected offspring
+  Eigen::VectorX<TypeParam> scored(Eigen::Index(r.get_population().size()));
+  Eigen::Index count = 0;
+  for (const auto &individual : r.get_population()) {
+    if (!individual->is_rejected()) {
+      scored(count++) = individual->overall_fitness();
+    }
+  }
+  EXPECT_NEAR(double(statistics.current_value(
+                  int(statistics_requests_factory<TypeParam>::stat_requests::average_fitness_stat))),
+              double(scored.head(count).mean()), 1E-3);
+  const auto &best = *r.get_best_individual();
+  EXPECT_FALSE(best.is_rejected());
+  EXPECT_NEAR(double(best.overall_fitness()),
+              double(best.genome().squaredNorm() + TypeParam(1E-3) * best.genome().cwiseAbs().sum()), 1E-3);
+}
+
+/*
+ * Sphere biased by one per level below the highest of three fidelity levels, counting the evaluations per level
+ */
+template <floating_point_type Fp_T> class multi_fidelity_sphere : public base_evaluation<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    const size_t fidelity = individual.fidelity();
+    _calls[fidelity]++;
+    individual.set_objective_fitness(objective_index, individual.genome().squaredNorm() + Fp_T(2 - fidelity));
+    return ++objective_index;
+  }
+
+  [[nodiscard]] size_t objective_count() const override {
+    return 1;
+  }
+
+  [[nodiscard]] size_t calls(size_t fidelity) const {
+    return _calls[fidelity];
+  }
+
+private:
+  mutable std::array<std::atomic_size_t, 3> _calls{};
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_successive_halving) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  auto evaluation = std::make_unique<multi_fidelity_sphere<TypeParam>>();
+  const auto *probe = evaluation.get();
+  setup<TypeParam> s;
+  s.set_population_size(16)
+      .set_generations(10)
+      .set_successive_halving(3, .5)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(8))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(8))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::move(evaluation));
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+  EXPECT_EQ(r.get_individual_zero()->fidelity(), 2);
+
+  // Half of each batch reaches the second level, a quarter the third
+  EXPECT_LT(probe->calls(1), probe->calls(0));
+  EXPECT_LT(probe->calls(2), probe->calls(1));
+  const auto &statistics = r.get_statistics();
+  double promotions = 0;
+  for (size_t generation = 0; generation < statistics.current_generation(); generation++) {
+    const double value = statistics.metric("promotions", generation);
+    promotions += std::isnan(value) ? 0. : value;
+  }
+  EXPECT_EQ(size_t(promotions), probe->calls(1) + probe->calls(2) - 1);
+
+  // Higher levels are unbiased, so the best individual went through every level
+  const auto &best = *r.get_best_individual();
+  EXPECT_EQ(best.fidelity(), 2);
+  EXPECT_NEAR(double(best.overall_fitness()), double(best.genome().squaredNorm()), 1E-3);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, individual_fitness_samples) {
+  base_individual<TypeParam> individual(genome_t<TypeParam>::Constant(3, 1.), 2);
+  individual.set_objective_fitness(0, 1.);
+  individual.set_objective_fitness(1, 2.);
+  EXPECT_EQ(individual.samples(), 1);
+  EXPECT_TRUE(std::isnan(individual.fitness_variance()));
+  individual.add_sample(Eigen::Vector2<TypeParam>(3., 4.));
+  EXPECT_EQ(individual.samples(), 2);
+  EXPECT_NEAR(individual.objective_fitness(0), 2., 1E-6);
+  EXPECT_NEAR(individual.objective_fitness(1), 3., 1E-6);
+  // Overall fitness samples 3 and 7
+  EXPECT_NEAR(individual.fitness_variance(), 8., 1E-5);
+  individual.reset_samples();
+  EXPECT_EQ(individual.samples(), 1);
+}
+
+/*
+ * Sphere with gaussian noise, counting its evaluations
+ */
+template <floating_point_type Fp_T> class noisy_sphere_evaluation : public base_evaluation<Fp_T> {
+public:
+  size_t operator()(base_individual<Fp_T> &individual, size_t objective_index) const override {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    std::normal_distribution<double> noise(0., 1.);
+    _calls++;
+    individual.set_objective_fitness(objective_index, individual.genome().squaredNorm() + Fp_T(noise(generator)));
+    return ++objective_index;
+  }
+
+  [[nodiscard]] size_t objective_count() const override {
+    return 1;
+  }
+
+  [[nodiscard]] size_t calls() const {
+    return _calls;
+  }
+
+private:
+  mutable std::atomic_size_t _calls{0};
+};
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, setup_run_racing) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  auto evaluation = std::make_unique<noisy_sphere_evaluation<TypeParam>>();
+  const auto *probe = evaluation.get();
+  setup<TypeParam> s;
+  s.set_population_size(20)
+      .set_generations(10)
+      .set_racing(6)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(8))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(10))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::move(evaluation));
+  runner<TypeParam> r(std::move(s));
+  ASSERT_EQ(r.run(), runner<TypeParam>::exit_flag::SUCCESS);
+
+  // Racing evaluations count like any other
+  const auto &statistics = r.get_statistics();
+  EXPECT_EQ(probe->calls(), statistics.evaluation_count());
+  double racing = 0;
+  for (size_t generation = 0; generation < statistics.current_generation(); generation++) {
+    const double value = statistics.metric("racing_evaluations", generation);
+    racing += std::isnan(value) ? 0. : value;
+  }
+  EXPECT_GT(racing, 0.);
+  EXPECT_LT(racing, double(probe->calls()));
+  size_t raced = 0;
+  for (const auto &individual : r.get_population()) {
+    EXPECT_LE(individual->samples(), 6);
+    raced += individual->samples() > 1;
+  }
+  EXPECT_GT(raced, 0);
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, ask_tell) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s;
+  s.set_population_size(10)
+      .set_generations(20)
+      .set_selection_for_reproduction(std::make_unique<truncation_selection_for_reproduction<TypeParam>>(4))
+      .set_selection_for_replacement(std::make_unique<truncation_selection_for_replacement<TypeParam>>(6))
+      .set_crossover(std::make_unique<uniform_linear_crossover<TypeParam>>(1.))
+      .set_mutation(std::make_unique<uniform_mutation<TypeParam>>(.05, 1.))
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  typename runner<TypeParam>::candidate_batch batch;
+  Eigen::MatrixX<TypeParam> objectives(1, 4);
+  size_t told = 0;
+  size_t failed = 0;
+  const TypeParam *buffer = nullptr;
+  while (!r.finished()) {
+    // Batches smaller than the population, as an external job queue would take them
+    ASSERT_GT(r.ask(4, batch), 0);
+    ASSERT_EQ(batch.genomes().cols(), batch.size());
+    EXPECT_TRUE(buffer == nullptr || batch.genomes().data() == buffer);
+    buffer = batch.genomes().data();
+    for (size_t i = 0; i < batch.size(); i++) {
+      objectives(0, long(i)) = batch.genomes().col(long(i)).squaredNorm();
+    }
+    // One candidate in ten fails and must be handed out again
+    if (told % 10 == 3) {
+      objectives(0, 0) = std::numeric_limits<TypeParam>::quiet_NaN();
+      failed++;
+    }
+    told += batch.size();
+    r.tell(batch, objectives.leftCols(long(batch.size())));
+    EXPECT_TRUE(batch.empty());
+  }
+  EXPECT_EQ(r.ask(4, batch), 0);
+  EXPECT_EQ(r.get_individual_zero()->genome(), initial_genome);
+  EXPECT_EQ(r.get_statistics().current_generation(), 20);
+  EXPECT_EQ(r.get_statistics().evaluation_count(), told - failed);
+  EXPECT_EQ(r.get_population().size(), 10);
+  ASSERT_LT(r.get_best_individual()->overall_fitness(), r.get_individual_zero()->overall_fitness());
+}
+
+TYPED_TEST(minimacore_genetic_algorithm_tests, ask_tell_failures) {
+  Eigen::VectorX<TypeParam> initial_genome = Eigen::VectorX<TypeParam>::Constant(3, 5.);
+  auto genome_gen = std::make_unique<genome_generator<TypeParam>>(initial_genome);
+  genome_gen->append_chromosome_generator(std::make_unique<chromosome_generator_impl<TypeParam>>(-5., 5.));
+  setup<TypeParam> s;
+  s.set_max_contiguous_failure_on_initialization(3);
+  s.set_population_size(4)
+      .set_generations(5)
+      .set_genome_generator(std::move(genome_gen))
+      .add_evaluation(std::make_unique<sphere_evaluation_function<TypeParam>>());
+  runner<TypeParam> r(std::move(s));
+  typename runner<TypeParam>::candidate_batch batch;
+  ASSERT_EQ(r.ask(2, batch), 2);
+  // A batch must be told before being asked again, with one column of objectives per candidate
+  EXPECT_EQ(r.ask(2, batch), 0);
+  EXPECT_FALSE(r.tell(batch, Eigen::MatrixX<TypeParam>::Zero(1, 1)));
+  EXPECT_FALSE(r.tell(batch, Eigen::MatrixX<TypeParam>::Zero(2, 2)));
+  ASSERT_EQ(batch.size(), 2);
+  const auto nan = std::numeric_limits<TypeParam>::quiet_NaN();
+  EXPECT_TRUE(r.tell(batch, Eigen::MatrixX<TypeParam>::Constant(1, 2, nan)));
+  // Individual zero is kept with its failed fitness, as run does
+  ASSERT_NE(r.get_individual_zero(), nullptr);
+  EXPECT_EQ(r.get_individual_zero()->genome(), initial_genome);
+  EXPECT_TRUE(std::isnan(r.get_individual_zero()->overall_fitness()));
+  EXPECT_FALSE(r.finished());
+  ASSERT_EQ(r.ask(4, batch), 4);
+  EXPECT_TRUE(r.tell(batch, Eigen::MatrixX<TypeParam>::Constant(1, 4, nan)));
+  // The initialization gives up after three failures in a row
+  EXPECT_TRUE(r.finished());
+  EXPECT_EQ(r.ask(4, batch), 0);
+  EXPECT_EQ(r.get_statistics().evaluation_count(), 0);
+}
@@ -33,8 +33,8 @@ inline T auckley(const Eigen::Vector<T, 2>& input)
          - std::exp<T>(0.5 * (std::cos<T>(2. * EIGEN_PI * x) + std::cos<T>(2. * EIGEN_PI * y))) + std::exp<T>() + 20.;
 }
 
-template<floating_point_type T>
-inline T sphere(const Eigen::VectorX<T>& input)
+template<typename Derived, typename T = typename Derived::Scalar>
+inline T sphere(const Eigen::MatrixBase<Derived>& input)
 {
   T result = 0.;
   for (size_t i = 0; i < input.size(); i++) result += square(input(i));
@@ -38,3 +38,200 @@
 //  std::this_thread::sleep_for(std::chrono::milliseconds(150));
 //  EXPECT_EQ(counter, 8);
 //}
+
+#include <gtest/gtest.h>
+#include <logger.h>
+#include <sstream>
+#include <thread>
+
+using namespace minimacore;
+
+TEST(logger_tests, concurrent_records)
+{
+  std::ostringstream output;
+  logger log;
+  log.add_stream(output);
+  constexpr size_t thread_count = 8;
+  constexpr size_t message_count = 500;
+  vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([&log, t]() {
+      for (size_t i = 0; i < message_count; i++) {
+        log.info() << "thread " << t << " message " << i << " value " << 0.5;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  logger::flush();
+
+  std::istringstream lines(output.str());
+  std::string line;
+  vector<size_t> next(thread_count, 0);
+  size_t count = 0;
+  while (std::getline(lines, line)) {
+    // Every line is one whole record, and the records of a thread keep their order
+    ASSERT_EQ(line.front(), '[');
+    ASSERT_EQ(line.substr(21, 2), "] ");
+    size_t t, i;
+    ASSERT_EQ(std::sscanf(line.c_str() + 23, "thread %zu message %zu value 0.5", &t, &i), 2) << line;
+    ASSERT_LT(t, thread_count);
+    EXPECT_EQ(i, next[t]++);
+    count++;
+  }
+  EXPECT_EQ(count, thread_count * message_count);
+}
+
+TEST(logger_tests, level_filter)
+{
+  std::ostringstream output;
+  logger log(log_level::WARNING);
+  log.add_stream(output);
+  log.info() << "dropped";
+  log.debug() << "dropped";
+  log.warning() << "kept";
+  log.set_level(log_level::DEBUG);
+  log.debug() << "also kept";
+  log.trace() << "dropped";
+  logger::flush();
+  const std::string text = output.str();
+  EXPECT_EQ(text.find("dropped"), std::string::npos);
+  EXPECT_NE(text.find("[warning] kept\n"), std::string::npos);
+  EXPECT_NE(text.find("[debug] also kept\n"), std::string::npos);
+}
+
+TEST(logger_tests, truncated_record)
+{
+  std::ostringstream output;
+  logger log;
+  log.add_stream(output);
+  constexpr size_t capacity = log_record<log_level::INFO>::capacity;
+  log.info() << std::string(capacity - 1, 'a') << 12345;
+  log.info() << std::string(capacity, 'b');
+  logger::flush();
+  std::istringstream lines(output.str());
+  std::string line;
+  ASSERT_TRUE(std::getline(lines, line));
+  EXPECT_TRUE(line.ends_with(std::string(capacity - 3, 'a') + "...")) << line;
+  ASSERT_TRUE(std::getline(lines, line));
+  EXPECT_TRUE(line.ends_with(std::string(capacity, 'b'))) << line;
+}
+
+#include <fstream>
+#include <thread_pool.h>
+#include <tracer.h>
+
+TEST(tracer_tests, chrome_trace_export)
+{
+  tracer::clear();
+  {
+    MINIMACORE_TRACE_SCOPE("disabled", "test");
+  }
+  EXPECT_EQ(tracer::event_count(), 0);
+
+  tracer::enable();
+  {
+    thread_pool pool(2);
+    vector<std::future<void>> futures;
+    for (size_t i = 0; i < 8; i++) {
+      futures.emplace_back(pool.enqueue([]() { MINIMACORE_TRACE_SCOPE("work", "test"); }));
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  }
+  tracer::disable();
+  // Every task records the pool's scope and its own
+  EXPECT_EQ(tracer::event_count(), 16);
+
+  const std::string path = "tracer_test.json";
+  ASSERT_TRUE(tracer::export_chrome_trace(path));
+  std::ifstream file(path);
+  const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+  EXPECT_NE(json.find(R"({"name":"work","cat":"test","ph":"X")"), std::string::npos);
+  EXPECT_NE(json.find(R"({"name":"task","cat":"thread_pool","ph":"X")"), std::string::npos);
+  EXPECT_NE(json.find(R"("args":{"name":"worker 1"})"), std::string::npos);
+  EXPECT_EQ(json.find("disabled"), std::string::npos);
+  file.close();
+  std::remove(path.c_str());
+  tracer::clear();
+}
+
+TEST(thread_pool_tests, lanes_round_robin)
+{
+  thread_pool pool(1);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::mutex mutex;
+  std::vector<int> order;
+  auto blocked = pool.enqueue([released]() { released.wait(); });
+  const size_t lane = pool.open_lane();
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 4; i++) {
+    futures.emplace_back(pool.enqueue([&, i]() {
+      std::lock_guard lock(mutex);
+      order.push_back(i);
+    }));
+  }
+  futures.emplace_back(pool.enqueue_on(lane, [&]() {
+    std::lock_guard lock(mutex);
+    order.push_back(-1);
+  }));
+  release.set_value();
+  for (auto& f : futures) {
+    f.get();
+  }
+  pool.close_lane(lane);
+  // The lane's only task is served before the remaining tasks of the busy lane
+  ASSERT_EQ(order.size(), 5);
+  EXPECT_LT(std::ranges::find(order, -1) - order.begin(), 2);
+  EXPECT_EQ(pool.open_lane(), lane);
+}
+
+#include <executor.h>
+#include <numeric>
+#include <parallel_reduce.h>
+
+TEST(parallel_reduce_tests, nested_reductions)
+{
+  constexpr size_t count = 100000;
+  auto map = [](size_t begin, size_t end) {
+    size_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+      sum += i;
+    }
+    return sum;
+  };
+  const size_t expected = count * (count - 1) / 2;
+  // Outside executor tasks the range is mapped inline
+  EXPECT_EQ(parallel_reduce(count, size_t{0}, map, std::plus<>{}), expected);
+
+  // More tasks waiting on nested parts than workers: the waiting tasks run the parts themselves
+  thread_pool pool(2);
+  thread_pool_executor executor(pool);
+  std::atomic_size_t split{0};
+  std::vector<std::future<size_t>> futures;
+  for (int task = 0; task < 8; task++) {
+    futures.emplace_back(executor.submit(
+        [&]() {
+          if (base_executor::nested_width() == 4) {
+            split++;
+          }
+          return parallel_reduce(size_t{64}, size_t{0},
+                                 [&](size_t begin, size_t end) {
+                                   return parallel_reduce(
+                                       count, size_t{0},
+                                       [&](size_t b, size_t e) { return (end - begin) * map(b, e); }, std::plus<>{},
+                                       1000);
+                                 },
+                                 std::plus<>{}, 16);
+        },
+        4));
+  }
+  for (auto& f : futures) {
+    EXPECT_EQ(f.get(), 64 * expected);
+  }
+  EXPECT_EQ(split.load(), 8);
+}